@@ -0,0 +1,277 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include "ansiparser.h"
+
+/**
+ * @brief AnsiParser::AnsiParser
+ *   Constructor of the class AnsiParser.
+ * @param base  format of text without rendition
+ */
+AnsiParser::AnsiParser(const QTextCharFormat &base)
+{
+    baseFormat = base;
+    format     = base;
+
+    return;
+}
+
+/**
+ * @brief AnsiParser::color256
+ *   Determines a color of the 256 color palette of xterm.
+ * @param num  0..15 = standard and bright colors, 16..231 = 6x6x6 color cube, 232..255 = gray scale
+ * @return color
+ */
+QColor AnsiParser::color256(int num)
+{
+    static const QRgb standard[16] = {
+        0x000000, 0xcd0000, 0x00cd00, 0xcdcd00, 0x0000ee, 0xcd00cd, 0x00cdcd, 0xe5e5e5,
+        0x7f7f7f, 0xff0000, 0x00ff00, 0xffff00, 0x5c5cff, 0xff00ff, 0x00ffff, 0xffffff
+    };
+
+    if (num < 0 || num > 255) return QColor();
+
+    if (num < 16) return QColor(standard[num]);
+
+    if (num < 232) {
+        num-= 16;
+        int r = num / 36;
+        int g = (num / 6) % 6;
+        int b = num % 6;
+        return QColor(r ? 55+r*40 : 0,g ? 55+g*40 : 0,b ? 55+b*40 : 0);
+    }
+
+    return QColor(8+(num-232)*10,8+(num-232)*10,8+(num-232)*10);
+}
+
+/**
+ * @brief AnsiParser::addRun
+ *   Adds a part of the parsed text with the current format to the runs.
+ * @param start
+ * @param end  position after the part
+ */
+void AnsiParser::addRun(int start, int end)
+{
+    if (end <= start) return;
+
+    Run run;
+
+    run.start  = start;
+    run.length = end - start;
+    run.format = format;  // implicitly shared
+
+    runs.append(run);
+
+    return;
+}
+
+/**
+ * @brief AnsiParser::parse
+ *   Parses a block of output. Text without escape character and without an unfinished
+ *   sequence of the previous block is one run without further parsing.
+ * @param text
+ * @return runs of the text; the positions refer to the parsed text
+ */
+const QList<AnsiParser::Run> &AnsiParser::parse(const QString &text)
+{
+    int    runStart = 0;
+    ushort ch;
+
+    runs.clear();
+
+    if (state == TEXT && !text.contains(QChar(0x1b))) {
+        addRun(0,text.size());
+        return runs;
+    }
+
+    for (int pos = 0; pos < text.size(); pos++) {
+        ch = text.at(pos).unicode();
+
+        switch (state) {
+            case TEXT:
+                if (ch == 0x1b) {
+                    addRun(runStart,pos);
+                    state = ESCAPE;
+                }
+                break;
+            case ESCAPE:
+                if (ch == '[') {
+                    state       = CSI;
+                    paramCount  = 0;
+                    paramDigits = false;
+                } else if (ch == ']') {
+                    state = OSC;
+                } else if (ch == '(' || ch == ')') {
+                    state = CHARSET;
+                } else {
+                    // sequence of two characters
+                    state    = TEXT;
+                    runStart = pos+1;
+                }
+                break;
+            case CSI:
+                if (ch >= '0' && ch <= '9') {
+                    if (paramCount < ANSIMAXPARAMS) {
+                        if (!paramDigits) params[paramCount] = 0;
+                        if (params[paramCount] < 100000) params[paramCount] = params[paramCount]*10 + (ch-'0');
+                    }
+                    paramDigits = true;
+                } else if (ch == ';' || ch == ':') {
+                    // an empty parameter is 0
+                    if (paramCount < ANSIMAXPARAMS) {
+                        if (!paramDigits) params[paramCount] = 0;
+                        paramCount++;
+                    }
+                    paramDigits = false;
+                } else if (ch >= 0x40 && ch <= 0x7e) {
+                    // final character of the sequence
+                    if (paramDigits && paramCount < ANSIMAXPARAMS) paramCount++;
+                    if (ch == 'm') selectRendition();
+                    state    = TEXT;
+                    runStart = pos+1;
+                }
+                break;
+            case OSC:
+                // operating system command, e.g. the window title; finished by BEL or ESC backslash
+                if (ch == 0x07) {
+                    state    = TEXT;
+                    runStart = pos+1;
+                } else if (ch == 0x1b) {
+                    state = OSCESCAPE;
+                }
+                break;
+            case OSCESCAPE:
+            case CHARSET:
+                state    = TEXT;
+                runStart = pos+1;
+                break;
+        }
+    }
+
+    if (state == TEXT) addRun(runStart,text.size());
+
+    return runs;
+}
+
+/**
+ * @brief AnsiParser::selectRendition
+ *   Sets the graphic rendition from the parameters of a SGR sequence.
+ */
+void AnsiParser::selectRendition()
+{
+    int param;
+
+    // ESC [ m = reset
+    if (paramCount == 0) {
+        params[0]  = 0;
+        paramCount = 1;
+    }
+
+    for (int idx = 0; idx < paramCount; idx++) {
+        param = params[idx];
+
+        if (param == 0) {
+            foreground = QColor();
+            background = QColor();
+            bold       = false;
+            italic     = false;
+            underline  = false;
+            reverse    = false;
+        } else if (param == 1) {
+            bold = true;
+        } else if (param == 3) {
+            italic = true;
+        } else if (param == 4) {
+            underline = true;
+        } else if (param == 7) {
+            reverse = true;
+        } else if (param == 22) {
+            bold = false;
+        } else if (param == 23) {
+            italic = false;
+        } else if (param == 24) {
+            underline = false;
+        } else if (param == 27) {
+            reverse = false;
+        } else if (param >= 30 && param <= 37) {
+            foreground = color256(param-30);
+        } else if (param == 39) {
+            foreground = QColor();
+        } else if (param >= 40 && param <= 47) {
+            background = color256(param-40);
+        } else if (param == 49) {
+            background = QColor();
+        } else if (param >= 90 && param <= 97) {
+            foreground = color256(param-90+8);
+        } else if (param >= 100 && param <= 107) {
+            background = color256(param-100+8);
+        } else if (param == 38 || param == 48) {
+            // 38;5;n = palette color, 38;2;r;g;b = true color
+            QColor color;
+            if (idx+2 < paramCount && params[idx+1] == 5) {
+                color = color256(params[idx+2]);
+                idx+= 2;
+            } else if (idx+4 < paramCount && params[idx+1] == 2) {
+                color = QColor(qMin(params[idx+2],255),qMin(params[idx+3],255),qMin(params[idx+4],255));
+                idx+= 4;
+            } else {
+                break;  // incomplete sequence => the remaining parameters are ignored
+            }
+            if (param == 38) foreground = color;
+            else background = color;
+        }
+    }
+
+    updateFormat();
+
+    return;
+}
+
+/**
+ * @brief AnsiParser::updateFormat
+ *   Creates the format of the current rendition.
+ */
+void AnsiParser::updateFormat()
+{
+    QColor fg = foreground;
+    QColor bg = background;
+
+    format = baseFormat;
+
+    if (reverse) {
+        if (!fg.isValid()) fg = baseFormat.foreground().style() != Qt::NoBrush ? baseFormat.foreground().color() : QColor(Qt::black);
+        if (!bg.isValid()) bg = baseFormat.background().style() != Qt::NoBrush ? baseFormat.background().color() : QColor(Qt::white);
+        std::swap(fg,bg);
+    }
+
+    if (fg.isValid()) format.setForeground(fg);
+    if (bg.isValid()) format.setBackground(bg);
+    if (bold)         format.setFontWeight(QFont::Bold);
+    if (italic)       format.setFontItalic(true);
+    if (underline)    format.setFontUnderline(true);
+
+    return;
+}
+
+/**
+ * @brief AnsiParser::isPlain
+ * @return true if no rendition is set
+ */
+bool AnsiParser::isPlain()
+{
+    return !foreground.isValid() && !background.isValid() && !bold && !italic && !underline && !reverse;
+}
@@ -0,0 +1,84 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef ANSIPARSER_H
+#define ANSIPARSER_H
+
+#include <utility>
+#include <QBrush>
+#include <QColor>
+#include <QFont>
+#include <QList>
+#include <QString>
+#include <QTextCharFormat>
+#include "main.h"
+
+/**
+ * @brief AnsiParser
+ *   Streaming parser of the ANSI escape sequences in the output of a command. The select
+ *   graphic rendition sequences (ESC [ ... m) are converted to character formats; all other
+ *   sequences are removed. The state is kept between the parsed blocks, so sequences split
+ *   between two blocks of output are recognized. The result are runs of text with the same
+ *   format, which are inserted into the document at once.
+ */
+class AnsiParser
+{
+    #define ANSIMAXPARAMS 16  // maximum number of parameters of a sequence
+
+  public:
+    // structure of a run = part of the parsed text with the same format
+    struct Run {
+        int start;
+        int length;
+        QTextCharFormat format;
+    };
+
+  private:
+    enum State { TEXT, ESCAPE, CSI, OSC, OSCESCAPE, CHARSET };
+
+    State state = TEXT;
+
+    int  params[ANSIMAXPARAMS];  // parameters of the current control sequence
+    int  paramCount = 0;
+    bool paramDigits = false;    // the current parameter contains digits
+
+    // graphic rendition set by the sequences
+    QColor foreground;           // invalid = default color
+    QColor background;
+    bool   bold      = false;
+    bool   italic    = false;
+    bool   underline = false;
+    bool   reverse   = false;
+
+    QTextCharFormat baseFormat;  // format of text without rendition
+    QTextCharFormat format;      // format of the current rendition
+
+    QList<Run> runs;
+
+    static QColor color256(int num);
+    void addRun(int start, int end);
+    void selectRendition();
+    void updateFormat();
+
+  public:
+    explicit AnsiParser(const QTextCharFormat &base);
+
+    const QList<Run> &parse(const QString &text);  // returns the runs of the text without the sequences
+    bool isPlain();                                // true if no rendition is set
+};
+
+#endif // ANSIPARSER_H
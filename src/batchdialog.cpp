@@ -0,0 +1,183 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include "batchdialog.h"
+
+/**
+ * @brief BatchDialog::BatchDialog
+ *   Constructor of the class BatchDialog. The dialog takes over the batch and deletes it
+ *   when it's closed.
+ * @param category
+ * @param batch
+ * @param parent
+ */
+BatchDialog::BatchDialog(const QString &category, BatchRunner *batch, QWidget *parent) : QDialog(parent)
+{
+    runner = batch;
+    runner->setParent(this);
+
+    setModal(false);
+    setAttribute(Qt::WA_DeleteOnClose);
+    setWindowTitle(tr("Run Category")+" - "+category);
+    resize(700,500);
+
+    QBoxLayout *batchLayout = new QBoxLayout(QBoxLayout::TopToBottom,this);
+    QSplitter  *splitter    = new QSplitter(Qt::Vertical,this);
+
+    table = new QTableWidget(runner->size(),4,this);
+    table->setHorizontalHeaderLabels(QStringList() << tr("Command") << tr("State") << tr("Exit code") << tr("Duration"));
+    table->horizontalHeader()->setSectionResizeMode(0,QHeaderView::Stretch);
+    table->verticalHeader()->setVisible(false);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->setSelectionMode(QAbstractItemView::SingleSelection);
+
+    for (int idx = 0; idx < runner->size(); idx++) {
+        table->setItem(idx,0,new QTableWidgetItem(runner->at(idx).command));
+        table->setItem(idx,1,new QTableWidgetItem());
+        table->setItem(idx,2,new QTableWidgetItem());
+        table->setItem(idx,3,new QTableWidgetItem());
+        table->item(idx,2)->setTextAlignment(Qt::AlignRight|Qt::AlignVCenter);
+        table->item(idx,3)->setTextAlignment(Qt::AlignRight|Qt::AlignVCenter);
+    }
+
+    output = new QPlainTextEdit(this);
+    output->setReadOnly(true);
+    output->setFont(QFont("Nimbus Mono PS",10));
+
+    splitter->addWidget(table);
+    splitter->addWidget(output);
+
+    batchLayout->addWidget(splitter);
+
+    summary     = new QLabel(this);
+    stopButton  = new QPushButton(tr("&Stop"),this);
+    closeButton = new QPushButton(tr("&Close"),this);
+
+    QBoxLayout *buttonLayout = new QBoxLayout(QBoxLayout::LeftToRight);
+
+    buttonLayout->addWidget(summary,1);
+    buttonLayout->addWidget(stopButton);
+    buttonLayout->addWidget(closeButton);
+
+    batchLayout->addLayout(buttonLayout);
+
+    connect(runner,SIGNAL(taskChanged_signal(int)),this,SLOT(taskChanged(int)));
+    connect(runner,SIGNAL(finished_signal()),this,SLOT(batchFinished()));
+    connect(table,SIGNAL(itemSelectionChanged()),this,SLOT(rowSelected()));
+    connect(stopButton,SIGNAL(clicked()),runner,SLOT(stop()));
+    connect(closeButton,SIGNAL(clicked()),this,SLOT(close()));
+
+    return;
+}
+
+/**
+ * @brief BatchDialog::stateText
+ * @param num
+ * @return state of a command as text
+ */
+QString BatchDialog::stateText(int num)
+{
+    const BatchRunner::Task &task = runner->at(num);
+
+    QString text;
+
+    switch (task.state) {
+        case BatchRunner::WAITING: text = tr("Waiting"); break;
+        case BatchRunner::RUNNING: text = tr("Running"); break;
+        case BatchRunner::DONE:    text = tr("Done");    break;
+        case BatchRunner::FAILED:  text = tr("Failed");  break;
+        case BatchRunner::SKIPPED: text = tr("Skipped"); break;
+    }
+
+    if (!task.message.isEmpty()) text+= " ("+task.message+")";
+
+    return text;
+}
+
+/**
+ * @brief BatchDialog::taskChanged
+ *   Updates the row of a command; the output is updated if the command is selected.
+ * @param num
+ */
+void BatchDialog::taskChanged(int num)
+{
+    const BatchRunner::Task &task = runner->at(num);
+
+    bool ended = (task.state == BatchRunner::DONE || task.state == BatchRunner::FAILED);
+
+    table->item(num,1)->setText(stateText(num));
+    table->item(num,2)->setText(ended ? QString::number(task.exitCode) : QString());
+    table->item(num,3)->setText(ended ? QString::number(task.msecs/1000.0,'f',3)+" s" : QString());
+
+    if (task.state == BatchRunner::FAILED) {
+        table->item(num,1)->setForeground(Qt::red);
+    } else if (task.state == BatchRunner::DONE) {
+        table->item(num,1)->setForeground(Qt::darkGreen);
+    }
+
+    // only the new output of the selected command is appended
+    if (table->currentRow() == num && task.output.size() > shownChars) {
+        output->moveCursor(QTextCursor::End);
+        output->insertPlainText(task.output.mid(shownChars));
+        shownChars = task.output.size();
+    }
+
+    return;
+}
+
+/**
+ * @brief BatchDialog::batchFinished
+ *   Displays the number of succeeded, failed and skipped commands.
+ */
+void BatchDialog::batchFinished()
+{
+    int done    = 0;
+    int failed  = 0;
+    int skipped = 0;
+
+    for (int idx = 0; idx < runner->size(); idx++) {
+        switch (runner->at(idx).state) {
+            case BatchRunner::DONE:    done++;    break;
+            case BatchRunner::FAILED:  failed++;  break;
+            case BatchRunner::SKIPPED: skipped++; break;
+            default:
+                break;
+        }
+    }
+
+    summary->setText(tr("%1 done, %2 failed, %3 skipped").arg(done).arg(failed).arg(skipped));
+    stopButton->setEnabled(false);
+
+    return;
+}
+
+/**
+ * @brief BatchDialog::rowSelected
+ *   Displays the output of the selected command.
+ */
+void BatchDialog::rowSelected()
+{
+    int num = table->currentRow();
+
+    if (num < 0) return;
+
+    output->setPlainText(runner->at(num).output);
+    shownChars = runner->at(num).output.size();
+
+    return;
+}
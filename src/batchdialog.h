@@ -0,0 +1,64 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef BATCHDIALOG_H
+#define BATCHDIALOG_H
+
+#include <QBoxLayout>
+#include <QDialog>
+#include <QFont>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPlainTextEdit>
+#include <QPushButton>
+#include <QSplitter>
+#include <QTableWidget>
+#include <QTableWidgetItem>
+#include <QTextCursor>
+#include "batchrunner.h"
+
+/**
+ * @brief BatchDialog
+ *   Displays the commands of a batch with their state, exit code and duration. The output
+ *   of the selected command is displayed below the table. The dialog isn't modal, so the
+ *   terminal window can be used while the batch runs; closing it stops the batch.
+ */
+class BatchDialog : public QDialog
+{
+    Q_OBJECT
+
+    BatchRunner    *runner;
+    QTableWidget   *table;
+    QPlainTextEdit *output;
+    QLabel         *summary;
+    QPushButton    *stopButton;
+    QPushButton    *closeButton;
+
+    int shownChars = 0;  // characters of the output of the selected command displayed
+
+    QString stateText(int num);
+
+  private slots:
+    void taskChanged(int num);
+    void batchFinished();
+    void rowSelected();
+
+  public:
+    BatchDialog(const QString &category, BatchRunner *batch, QWidget *parent = nullptr);
+};
+
+#endif // BATCHDIALOG_H
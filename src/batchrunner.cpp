@@ -0,0 +1,406 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include "batchrunner.h"
+
+using namespace std;
+
+/**
+ * @brief BatchRunner::BatchRunner
+ *   Constructor of the class BatchRunner.
+ * @param parent
+ */
+BatchRunner::BatchRunner(QObject *parent) : QObject(parent)
+{
+    return;
+}
+
+/**
+ * @brief BatchRunner::~BatchRunner
+ *   Destructor of the class BatchRunner. The running commands are killed.
+ */
+BatchRunner::~BatchRunner()
+{
+    for (int idx = 0; idx < tasks.size(); idx++) {
+        if (tasks.at(idx).process != nullptr) {
+            tasks.at(idx).process->disconnect(this);
+            delete tasks.at(idx).process;  // kills a running process
+        }
+        delete tasks.at(idx).decoder;
+    }
+
+    return;
+}
+
+/**
+ * @brief BatchRunner::addTask
+ *   Adds a command to the batch; the notes may contain its name, its dependencies and its limits.
+ * @param command
+ * @param notes
+ * @param lim  default limits of the command
+ */
+void BatchRunner::addTask(const QString &command, const QStringList &notes, const LimitedProcess::Limits &lim)
+{
+    Task task;
+
+    task.command = command.trimmed();
+    task.name    = task.command;
+    task.limits  = lim;
+
+    for (int idx = 0; idx < notes.size(); idx++) {
+        QString line = notes.at(idx).trimmed();
+        if (line.startsWith("@name=")) {
+            task.name = line.mid(6).trimmed();
+        } else if (line.startsWith("@after=")) {
+            QStringList names = line.mid(7).split(',');
+            for (int num = 0; num < names.size(); num++) {
+                if (!names.at(num).trimmed().isEmpty()) task.after << names.at(num).trimmed();
+            }
+        } else {
+            LimitedProcess::parseLimit(line,task.limits);
+        }
+    }
+
+    tasks << task;
+
+    return;
+}
+
+/**
+ * @brief BatchRunner::resolve
+ *   Converts the names of the dependencies to numbers and skips the commands with unknown
+ *   dependencies or dependencies in a cycle. The cycles are found by sorting the commands
+ *   topologically (Kahn): commands never getting free of dependencies are part of a cycle
+ *   or depend on one.
+ */
+void BatchRunner::resolve()
+{
+    QHash<QString,int> names;
+    QList<int> pending;     // number of unresolved dependencies of each command
+    QList<int> ready;
+    int sorted = 0;
+
+    for (int idx = 0; idx < tasks.size(); idx++) {
+        if (!names.contains(tasks.at(idx).name)) names.insert(tasks.at(idx).name,idx);
+    }
+
+    for (int idx = 0; idx < tasks.size(); idx++) {
+        Task &task = tasks[idx];
+        for (int num = 0; num < task.after.size(); num++) {
+            if (!names.contains(task.after.at(num))) {
+                task.state   = SKIPPED;
+                task.message = tr("Unknown dependency")+" "+task.after.at(num);
+                break;
+            }
+            int dep = names.value(task.after.at(num));
+            if (dep != idx && !task.deps.contains(dep)) task.deps << dep;
+        }
+        pending << task.deps.size();
+        if (task.deps.isEmpty()) ready << idx;
+    }
+
+    while (!ready.isEmpty()) {
+        int idx = ready.takeFirst();
+        sorted++;
+        for (int num = 0; num < tasks.size(); num++) {
+            if (tasks.at(num).deps.contains(idx) && --pending[num] == 0) ready << num;
+        }
+    }
+
+    if (sorted == tasks.size()) return;
+
+    for (int idx = 0; idx < tasks.size(); idx++) {
+        if (pending.at(idx) > 0 && tasks.at(idx).state == WAITING) {
+            tasks[idx].state   = SKIPPED;
+            tasks[idx].message = tr("Dependency cycle");
+        }
+    }
+
+    return;
+}
+
+/**
+ * @brief BatchRunner::start
+ * @param dir          working directory of the commands
+ * @param maxParallel  maximum number of commands running at the same time
+ */
+void BatchRunner::start(const QString &dir, int maxParallel)
+{
+    workDir  = dir;
+    parallel = qMax(maxParallel,1);
+
+    resolve();
+
+    for (int idx = 0; idx < tasks.size(); idx++) {
+        emit taskChanged_signal(idx);
+    }
+
+    schedule();
+
+    return;
+}
+
+/**
+ * @brief BatchRunner::schedule
+ *   Skips the commands depending on a failed or skipped command and starts the commands
+ *   whose dependencies are done, in the order of the category, until the maximum number
+ *   of running commands is reached.
+ */
+void BatchRunner::schedule()
+{
+    bool changed = true;
+
+    // skipping a command may skip the commands depending on it
+    while (changed) {
+        changed = false;
+        for (int idx = 0; idx < tasks.size(); idx++) {
+            if (tasks.at(idx).state != WAITING) continue;
+            for (int num = 0; num < tasks.at(idx).deps.size(); num++) {
+                State depState = tasks.at(tasks.at(idx).deps.at(num)).state;
+                if (depState == FAILED || depState == SKIPPED || stopped) {
+                    tasks[idx].state   = SKIPPED;
+                    tasks[idx].message = stopped ? tr("Stopped") : tr("Dependency failed")+": "+tasks.at(tasks.at(idx).deps.at(num)).name;
+                    emit taskChanged_signal(idx);
+                    changed = true;
+                    break;
+                }
+            }
+            if (stopped && tasks.at(idx).state == WAITING) {
+                tasks[idx].state   = SKIPPED;
+                tasks[idx].message = tr("Stopped");
+                emit taskChanged_signal(idx);
+            }
+        }
+    }
+
+    for (int idx = 0; idx < tasks.size() && running < parallel; idx++) {
+        if (tasks.at(idx).state != WAITING) continue;
+        bool free = true;
+        for (int num = 0; num < tasks.at(idx).deps.size() && free; num++) {
+            if (tasks.at(tasks.at(idx).deps.at(num)).state != DONE) free = false;
+        }
+        if (free) launch(idx);
+    }
+
+    // the start of a command may fail immediately and schedule again => finished only once
+    if (running == 0 && isFinished() && !done) {
+        done = true;
+        emit finished_signal();
+    }
+
+    return;
+}
+
+/**
+ * @brief BatchRunner::launch
+ *   Starts a command in a shell; standard output and standard error are collected together.
+ * @param num
+ */
+void BatchRunner::launch(int num)
+{
+    Task &task = tasks[num];
+
+    task.process = new LimitedProcess(this);
+    task.decoder = new OutputDecoder(
+                     #ifdef Q_OS_WIN
+                       OutputDecoder::IBM850
+                     #else
+                       OutputDecoder::UTF8
+                     #endif
+                   );
+
+    task.process->setWorkingDirectory(workDir);
+    task.process->setProcessChannelMode(QProcess::MergedChannels);
+    task.process->setLimits(task.limits);
+
+    connect(task.process,SIGNAL(readyReadStandardOutput()),this,SLOT(taskReadyRead()));
+    connect(task.process,SIGNAL(finished(int,QProcess::ExitStatus)),this,SLOT(taskFinished(int,QProcess::ExitStatus)));
+    connect(task.process,SIGNAL(errorOccurred(QProcess::ProcessError)),this,SLOT(taskError(QProcess::ProcessError)));
+    connect(task.process,SIGNAL(timedOut_signal()),this,SLOT(taskTimedOut()));
+
+    task.state = RUNNING;
+    task.timer.start();
+    running++;
+
+    emit taskChanged_signal(num);
+
+  #ifdef Q_OS_WIN
+    task.process->start("cmd",QStringList() << "/C" << task.command);
+  #else
+    task.process->start("/bin/sh",QStringList() << "-c" << task.command);
+  #endif
+
+    return;
+}
+
+/**
+ * @brief BatchRunner::finish
+ *   Finishes a command and starts the next commands.
+ * @param num
+ * @param state  DONE or FAILED
+ */
+void BatchRunner::finish(int num, State state)
+{
+    Task &task = tasks[num];
+
+    if (task.state != RUNNING) return;
+
+    task.state = state;
+    task.msecs = task.timer.elapsed();
+
+    // the process is deleted later, it's still in its signal
+    task.process->disconnect(this);
+    task.process->deleteLater();
+    task.process = nullptr;
+
+    running--;
+
+    emit taskChanged_signal(num);
+
+    schedule();
+
+    return;
+}
+
+/**
+ * @brief BatchRunner::findTask
+ * @param process
+ * @return number of the command executed by the process; -1 = not found
+ */
+int BatchRunner::findTask(QObject *process)
+{
+    for (int idx = 0; idx < tasks.size(); idx++) {
+        if (tasks.at(idx).process == process) return idx;
+    }
+
+    return -1;
+}
+
+/**
+ * @brief BatchRunner::taskReadyRead
+ *   Collects the output of a command; output beyond BATCHMAXOUTPUT characters is discarded.
+ */
+void BatchRunner::taskReadyRead()
+{
+    int num = findTask(sender());
+
+    if (num < 0) return;
+
+    Task &task = tasks[num];
+
+    QString text = task.decoder->decode(task.process->readAllStandardOutput());
+
+    if (task.output.size() < BATCHMAXOUTPUT) {
+        task.output+= text.left(BATCHMAXOUTPUT - task.output.size());
+        if (task.output.size() >= BATCHMAXOUTPUT) task.output+= "\n"+tr("[output truncated]")+"\n";
+    }
+
+    emit taskChanged_signal(num);
+
+    return;
+}
+
+/**
+ * @brief BatchRunner::taskFinished
+ * @param exitCode
+ * @param exitStatus
+ */
+void BatchRunner::taskFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    int num = findTask(sender());
+
+    if (num < 0) return;
+
+    taskReadyRead();
+
+    Task &task = tasks[num];
+
+    task.exitCode = exitCode;
+
+    if (exitStatus != QProcess::NormalExit && task.message.isEmpty()) task.message = tr("Crashed");
+
+    finish(num,(exitStatus == QProcess::NormalExit && exitCode == 0) ? DONE : FAILED);
+
+    return;
+}
+
+/**
+ * @brief BatchRunner::taskError
+ *   A command not started doesn't emit finished().
+ * @param error
+ */
+void BatchRunner::taskError(QProcess::ProcessError error)
+{
+    int num = findTask(sender());
+
+    if (num < 0 || error != QProcess::FailedToStart) return;
+
+    tasks[num].exitCode = -1;
+    tasks[num].message  = tr("Failed to start");
+
+    finish(num,FAILED);
+
+    return;
+}
+
+/**
+ * @brief BatchRunner::taskTimedOut
+ */
+void BatchRunner::taskTimedOut()
+{
+    int num = findTask(sender());
+
+    if (num < 0) return;
+
+    tasks[num].message = tr("Timed out");
+    tasks[num].process->kill();
+
+    return;
+}
+
+/**
+ * @brief BatchRunner::stop
+ *   Kills the running commands; the waiting commands are skipped.
+ */
+void BatchRunner::stop()
+{
+    stopped = true;
+
+    for (int idx = 0; idx < tasks.size(); idx++) {
+        if (tasks.at(idx).process != nullptr) {
+            tasks[idx].message = tr("Stopped");
+            tasks.at(idx).process->kill();
+        }
+    }
+
+    schedule();
+
+    return;
+}
+
+/**
+ * @brief BatchRunner::isFinished
+ * @return true if no command is waiting or running
+ */
+bool BatchRunner::isFinished()
+{
+    for (int idx = 0; idx < tasks.size(); idx++) {
+        if (tasks.at(idx).state == WAITING || tasks.at(idx).state == RUNNING) return false;
+    }
+
+    return true;
+}
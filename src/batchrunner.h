@@ -0,0 +1,107 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include <iostream>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QProcess>
+#include <QString>
+#include <QStringList>
+#include "main.h"
+#include "limitedprocess.h"
+#include "outputdecoder.h"
+
+/**
+ * @brief BatchRunner
+ *   Executes the commands of a category as a batch. At most a given number of commands
+ *   run at the same time; a command starts when the commands it depends on finished
+ *   successfully. The dependencies are given in the notes of a command: "@name=..." names
+ *   the command (default: the command itself) and "@after=name1,name2" lists the commands
+ *   it runs after. Commands depending on a failed command are skipped. The output of every
+ *   command is collected separately.
+ */
+class BatchRunner : public QObject
+{
+    Q_OBJECT
+
+    #define BATCHMAXOUTPUT 4194304  // maximum number of characters of output kept per command
+
+  public:
+    enum State { WAITING, RUNNING, DONE, FAILED, SKIPPED };
+
+    // structure of a command of the batch
+    struct Task {
+        QString     command;
+        QString     name;
+        QStringList after;         // names of the commands this command depends on
+        QList<int>  deps;          // numbers of the commands this command depends on
+        LimitedProcess::Limits limits;
+        State       state = WAITING;
+        int         exitCode = 0;
+        qint64      msecs = 0;     // duration
+        QString     output;        // standard output and standard error
+        QString     message;       // reason of a failure or of skipping the command
+        LimitedProcess *process = nullptr;
+        OutputDecoder  *decoder = nullptr;
+        QElapsedTimer   timer;
+    };
+
+  private:
+    QList<Task> tasks;
+
+    QString workDir;
+    int     parallel = 1;  // maximum number of commands running at the same time
+    int     running  = 0;  // number of running commands
+    bool    stopped  = false;
+    bool    done     = false;  // finished_signal() emitted
+
+    void resolve();
+    void schedule();
+    void launch(int num);
+    void finish(int num, State state);
+    int  findTask(QObject *process);
+
+  private slots:
+    void taskReadyRead();
+    void taskFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void taskError(QProcess::ProcessError error);
+    void taskTimedOut();
+
+  public:
+    explicit BatchRunner(QObject *parent = nullptr);
+    ~BatchRunner();
+
+    void addTask(const QString &command, const QStringList &notes, const LimitedProcess::Limits &lim);
+    void start(const QString &dir, int maxParallel);  // starts the batch
+    int  size() { return tasks.size(); }
+    const Task &at(int num) { return tasks.at(num); }
+    bool isFinished();
+
+  public slots:
+    void stop();  // kills the running commands and skips the waiting commands
+
+  signals:
+    void taskChanged_signal(int);  // state or output of a command changed
+    void finished_signal();        // all commands finished or were skipped
+};
+
+#endif // BATCHRUNNER_H
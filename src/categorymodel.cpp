@@ -0,0 +1,165 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include "categorymodel.h"
+
+/**
+ * @brief CategoryModel::CategoryModel
+ *   Constructor of the class CategoryModel.
+ * @param db      data records of the command library
+ * @param parent
+ */
+CategoryModel::CategoryModel(DBAccess *db, QObject *parent) : QAbstractListModel(parent)
+{
+    dbAccess = db;
+
+    dbAccess->addListener(this);
+
+    return;
+}
+
+/**
+ * @brief CategoryModel::~CategoryModel
+ *   Destructor of the class CategoryModel.
+ */
+CategoryModel::~CategoryModel()
+{
+    dbAccess->removeListener(this);
+
+    return;
+}
+
+/**
+ * @brief CategoryModel::rowCount
+ * @param parent
+ * @return number of categories
+ */
+int CategoryModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) return 0;
+
+    return dbAccess->catCount();
+}
+
+/**
+ * @brief CategoryModel::data
+ * @param index
+ * @param role
+ * @return name of the category
+ */
+QVariant CategoryModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || (role != Qt::DisplayRole && role != Qt::EditRole)) return QVariant();
+
+    return QString::fromStdString(dbAccess->catAt(index.row()));
+}
+
+/**
+ * @brief CategoryModel::recordAboutToBeAdded
+ *   Starts inserting the row of a new category.
+ * @param cat
+ * @param num
+ * @param newCat
+ */
+void CategoryModel::recordAboutToBeAdded(int cat, int num, bool newCat)
+{
+    Q_UNUSED(num);
+
+    if (newCat) {
+        beginInsertRows(QModelIndex(),cat,cat);
+    }
+
+    return;
+}
+
+/**
+ * @brief CategoryModel::recordAdded
+ *   Finishes inserting the row of a new category.
+ * @param cat
+ * @param num
+ * @param newCat
+ */
+void CategoryModel::recordAdded(int cat, int num, bool newCat)
+{
+    Q_UNUSED(cat);
+    Q_UNUSED(num);
+
+    if (newCat) {
+        endInsertRows();
+    }
+
+    return;
+}
+
+/**
+ * @brief CategoryModel::recordAboutToBeRemoved
+ *   Starts removing the row of a category losing its last command.
+ * @param cat
+ * @param num
+ * @param lastCmd
+ */
+void CategoryModel::recordAboutToBeRemoved(int cat, int num, bool lastCmd)
+{
+    Q_UNUSED(num);
+
+    if (lastCmd) {
+        beginRemoveRows(QModelIndex(),cat,cat);
+    }
+
+    return;
+}
+
+/**
+ * @brief CategoryModel::recordRemoved
+ *   Finishes removing the row of a category without commands.
+ * @param cat
+ * @param num
+ * @param lastCmd
+ */
+void CategoryModel::recordRemoved(int cat, int num, bool lastCmd)
+{
+    Q_UNUSED(cat);
+    Q_UNUSED(num);
+
+    if (lastCmd) {
+        endRemoveRows();
+    }
+
+    return;
+}
+
+/**
+ * @brief CategoryModel::recordsAboutToBeReset
+ *   Starts resetting the views before the data records are read, cleared or sorted.
+ */
+void CategoryModel::recordsAboutToBeReset()
+{
+    beginResetModel();
+
+    return;
+}
+
+/**
+ * @brief CategoryModel::recordsReset
+ *   Finishes resetting the views.
+ */
+void CategoryModel::recordsReset()
+{
+    endResetModel();
+
+    return;
+}
@@ -0,0 +1,55 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef CATEGORYMODEL_H
+#define CATEGORYMODEL_H
+
+#include <QAbstractListModel>
+#include <QModelIndex>
+#include <QString>
+#include <QVariant>
+#include "dbaccess.h"
+#include "main.h"
+
+/**
+ * @brief CategoryModel
+ *   List model of the categories of the command library. The names are read from the
+ *   index of DBAccess when a view displays them; the model keeps no copy of the list.
+ *   As listener of DBAccess the model inserts and removes the changed rows only.
+ */
+class CategoryModel : public QAbstractListModel, public DBAccess::Listener
+{
+    Q_OBJECT
+
+    DBAccess *dbAccess;
+
+  public:
+    explicit CategoryModel(DBAccess *db, QObject *parent = nullptr);
+    ~CategoryModel();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    void recordAboutToBeAdded(int cat, int num, bool newCat) override;
+    void recordAdded(int cat, int num, bool newCat) override;
+    void recordAboutToBeRemoved(int cat, int num, bool lastCmd) override;
+    void recordRemoved(int cat, int num, bool lastCmd) override;
+    void recordsAboutToBeReset() override;
+    void recordsReset() override;
+};
+
+#endif // CATEGORYMODEL_H
@@ -50,13 +50,10 @@ CfgAccess::byte CfgAccess::setConfig(string fn)
 CfgAccess::byte CfgAccess::readConfig()
 {
     byte result = 0;
-    int  size;
-    int  pos;
-    char entry[256];
+    size_t pos;
     string cfgtitle_str(cfgtitle);
     string cfgident_str;
     string keyValLine;
-    record *rec = nullptr;
 
     ioresult = CONFIG_READ;
 
@@ -65,10 +62,9 @@ CfgAccess::byte CfgAccess::readConfig()
 
     if (cfgstream) {
         // check the file identifier
-        cfgstream.getline(entry,256);
-        cfgident_str+= entry;
+        getline(cfgstream,cfgident_str);
         // Does the line finish with a carriage return?
-        if (cfgident_str.at(cfgident_str.size()-1) == 13) {
+        if (!cfgident_str.empty() && cfgident_str.at(cfgident_str.size()-1) == 13) {
             cfgident_str = cfgident_str.substr(0,cfgident_str.size()-1);
             lineEndCR = 1;
           #ifdef DEBUG
@@ -79,18 +75,16 @@ CfgAccess::byte CfgAccess::readConfig()
         // File identifier found?
         if (cfgident_str == cfgtitle_str) {
             // read the configuration
-            do {
-                cfgstream.getline(entry,256);
-                size = cfgstream.gcount();
-                if (size > 0) {
-                    keyValLine = entry;
-                    pos = keyValLine.find('=',0);
-                    rec = new record;
-                    rec->key.assign(keyValLine,0,pos);
-                    rec->value.assign(keyValLine,pos+1,size-(pos+1)-1-lineEndCR);  // -2 due to size contains the zero termination of entry
-                    records.push_back(*rec);
+            records.clear();
+            while (getline(cfgstream,keyValLine)) {
+                if (lineEndCR && !keyValLine.empty() && keyValLine.at(keyValLine.size()-1) == 13) {
+                    keyValLine.erase(keyValLine.size()-1);
                 }
-            } while (size > 0);
+                pos = keyValLine.find('=',0);
+                // lines without a key/value pair are skipped
+                if (pos == string::npos) continue;
+                records[keyValLine.substr(0,pos)].value = keyValLine.substr(pos+1);
+            }
 
             cfgstream.close();
           #ifdef DEBUG
@@ -114,6 +108,9 @@ CfgAccess::byte CfgAccess::readConfig()
         result   = 1;
     }
 
+    // the configuration in memory corresponds to the file now
+    dirty = false;
+
     cout.flush();
 
     return result;
@@ -121,31 +118,75 @@ CfgAccess::byte CfgAccess::readConfig()
 
 /**
  * @brief CfgAccess::writeConfig
- * @return
+ *   Writes the configuration to the configuration file. An unmodified configuration
+ *   isn't written. The configuration is written to a temporary file at first, which
+ *   then replaces the configuration file, so an aborted write never leaves a truncated
+ *   configuration file behind.
+ * @return writing result
+ *   0 = configuration written or unmodified
+ *   1 = could not create the temporary file
+ *   2 = could not replace the configuration file
  */
 CfgAccess::byte CfgAccess::writeConfig()
 {
-    byte result  = 0;
-    iterRec iter = records.begin();
+    byte result = 0;
+    string tmpFilename = filename + ".tmp";
     string keyValLine;
 
+    // Configuration unmodified?
+    if (!dirty) {
+      #ifdef DEBUG
+        cout << "Configuration unmodified.\n";
+        cout.flush();
+      #endif
+        return result;
+    }
+
+    // sort the keys for writing the configuration always in the same order
+    map<string,string> sorted;
+
+    for (iterRec iter = records.begin(); iter != records.end(); iter++) {
+        sorted[iter->first] = iter->second.value;
+    }
+
     // out=open the file for output, trunc=delete an existing file before opening
-    cfgstream.open(filename,ios_base::out|ios_base::trunc);
+    cfgstream.open(tmpFilename,ios_base::out|ios_base::trunc);
 
     if (cfgstream) {
-        // write the file identifier to the configuration file
+        // write the file identifier and the configuration as one block to the temporary file
         keyValLine = cfgtitle;
-        cfgstream.write(keyValLine.c_str(),keyValLine.size());
 
-        while (iter!= records.end()) {
-            keyValLine = iter->key;
+        for (map<string,string>::iterator iter = sorted.begin(); iter != sorted.end(); iter++) {
+            keyValLine+= iter->first;
             keyValLine+= '=';
-            keyValLine+= iter->value;
+            keyValLine+= iter->second;
             keyValLine+= '\n';
-            cfgstream.write(keyValLine.c_str(),keyValLine.size());
-            iter++;
         }
+
+        cfgstream.write(keyValLine.c_str(),keyValLine.size());
         cfgstream.close();
+
+        // Temporary file completely written?
+        if (cfgstream.fail()) {
+            remove(tmpFilename.c_str());
+            result = 1;
+        } else {
+          #ifdef _WIN32
+            // under Windows rename() doesn't replace an existing file
+            remove(filename.c_str());
+          #endif
+            if (rename(tmpFilename.c_str(),filename.c_str()) != 0) {
+                remove(tmpFilename.c_str());
+                result = 2;
+            }
+        }
+    } else {
+        result = 1;
+    }
+
+    if (result == 0) {
+        dirty    = false;
+        ioresult = CONFIG_WRITTEN;
       #ifdef DEBUG
         cout << "Configuration written.\n";
       #endif
@@ -153,7 +194,6 @@ CfgAccess::byte CfgAccess::writeConfig()
       #ifdef DEBUG
         cout << "ERROR! Can't create the configuration file.\n";
       #endif
-        result = 1;
     }
 
     cout.flush();
@@ -161,6 +201,20 @@ CfgAccess::byte CfgAccess::writeConfig()
     return result;
 }
 
+/**
+ * @brief CfgAccess::findRecord
+ * @param key
+ * @return record assigned to the key or nullptr
+ */
+CfgAccess::record *CfgAccess::findRecord(string key)
+{
+    iterRec iter = records.find(key);
+
+    if (iter == records.end()) return nullptr;
+
+    return &iter->second;
+}
+
 /**
  * @brief CfgAccess::getValue
  * @param key
@@ -168,18 +222,94 @@ CfgAccess::byte CfgAccess::writeConfig()
  */
 string CfgAccess::getValue(string key)
 {
-    string value = "";
-    iterRec iter = records.begin();
+    record *rec = findRecord(key);
+
+    if (rec == nullptr) return "";
+
+    return rec->value;
+}
+
+/**
+ * @brief CfgAccess::getInt
+ *   The value is converted only on the first access.
+ * @param key
+ * @param defVal  returned if the key doesn't exist or isn't an integer
+ * @return value assigned to the key as integer
+ */
+int CfgAccess::getInt(string key, int defVal)
+{
+    record *rec = findRecord(key);
+
+    if (rec == nullptr) return defVal;
+
+    if (!rec->intParsed) {
+        const char *str = rec->value.c_str();
+        char *end;
+
+        rec->intValue  = (int)strtol(str,&end,10);
+        rec->intValid  = (end != str && *end == 0);
+        rec->intParsed = true;
+    }
+
+    return rec->intValid ? rec->intValue : defVal;
+}
+
+/**
+ * @brief CfgAccess::getBool
+ * @param key
+ * @param defVal  returned if the key doesn't exist or isn't a boolean
+ * @return value assigned to the key as boolean
+ */
+bool CfgAccess::getBool(string key, bool defVal)
+{
+    record *rec = findRecord(key);
+
+    if (rec == nullptr) return defVal;
+
+    if (!rec->boolParsed) {
+        rec->boolParsed = true;
+        rec->boolValid  = true;
+        if (rec->value == "true" || rec->value == "1") {
+            rec->boolValue = true;
+        } else if (rec->value == "false" || rec->value == "0") {
+            rec->boolValue = false;
+        } else {
+            rec->boolValid = false;
+        }
+    }
+
+    return rec->boolValid ? rec->boolValue : defVal;
+}
+
+/**
+ * @brief CfgAccess::getStringList
+ *   The strings of the list are separated by semicolons in the configuration file.
+ * @param key
+ * @return value assigned to the key as list of strings
+ */
+list<string> CfgAccess::getStringList(string key)
+{
+    record *rec = findRecord(key);
+
+    if (rec == nullptr) return list<string>();
+
+    if (!rec->listParsed) {
+        size_t start = 0;
+        size_t pos;
+
+        rec->listValue.clear();
 
-    while (iter!= records.end()) {
-        if (iter->key == key) {
-            value = iter->value;
-            break;
+        while (start < rec->value.size()) {
+            pos = rec->value.find(';',start);
+            if (pos == string::npos) pos = rec->value.size();
+            rec->listValue.push_back(rec->value.substr(start,pos-start));
+            start = pos + 1;
         }
-        iter++;
+
+        rec->listParsed = true;
     }
 
-    return value;
+    return rec->listValue;
 }
 
 /**
@@ -192,27 +322,62 @@ string CfgAccess::getValue(string key)
 CfgAccess::byte CfgAccess::setValue(string key, string value)
 {
     byte result  = 0;
-    iterRec iter = records.begin();
-
-    while (iter != records.end()) {
-        if (iter->key == key) {
-            iter->value = value;
-            break;
-        }
-        iter++;
-    }
+    iterRec iter = records.find(key);
 
     if (iter == records.end()) {
-        record *rec = new record;
-        rec->key = key;
-        rec->value = value;
-        records.push_back(*rec);
+        records[key].value = value;
+        dirty  = true;
         result = 1;
+    } else if (iter->second.value != value) {
+        // a changed value invalidates the parsed representations
+        iter->second = record();
+        iter->second.value = value;
+        dirty = true;
     }
 
     return result;
 }
 
+/**
+ * @brief CfgAccess::setInt
+ * @param key
+ * @param value
+ * @return see setValue
+ */
+CfgAccess::byte CfgAccess::setInt(string key, int value)
+{
+    return setValue(key,to_string(value));
+}
+
+/**
+ * @brief CfgAccess::setBool
+ * @param key
+ * @param value
+ * @return see setValue
+ */
+CfgAccess::byte CfgAccess::setBool(string key, bool value)
+{
+    return setValue(key,value ? "true" : "false");
+}
+
+/**
+ * @brief CfgAccess::setStringList
+ * @param key
+ * @param value
+ * @return see setValue
+ */
+CfgAccess::byte CfgAccess::setStringList(string key, list<string> value)
+{
+    string joined;
+
+    for (list<string>::iterator iter = value.begin(); iter != value.end(); iter++) {
+        if (iter != value.begin()) joined+= ';';
+        joined+= *iter;
+    }
+
+    return setValue(key,joined);
+}
+
 /**
  * @brief removeKey
  * @param key
@@ -222,15 +387,10 @@ CfgAccess::byte CfgAccess::setValue(string key, string value)
 CfgAccess::byte CfgAccess::removeKey(string key)
 {
     byte result = 1;
-    iterRec iter = records.begin();
 
-    while (iter != records.end()) {
-        if (iter->key == key) {
-            records.erase(iter);
-            result = 0;
-            break;
-        }
-        iter++;
+    if (records.erase(key) > 0) {
+        dirty  = true;
+        result = 0;
     }
 
     return result;
@@ -18,10 +18,14 @@
 #ifndef CFGACCESS_H
 #define CFGACCESS_H
 
+#include <cstdio>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <list>
+#include <map>
 #include <string>
+#include <unordered_map>
 #include "main.h"
 
 const char cfgtitle[] = "### CONFIGURATION COMMAND LIBRARY ###\n";
@@ -42,28 +46,47 @@ class CfgAccess
 
     int lineEndCR;
 
-    // structure of a data record
+    // structure of a data record; the parsed representations of the value
+    // are filled on the first typed access and reset if the value changes
     struct record {
-        string key;
         string value;
+        bool   intParsed  = false;
+        bool   intValid   = false;
+        int    intValue   = 0;
+        bool   boolParsed = false;
+        bool   boolValid  = false;
+        bool   boolValue  = false;
+        bool   listParsed = false;
+        list<string> listValue;
     };
 
-    typedef list<record>::iterator iterRec;
+    typedef unordered_map<string,record>::iterator iterRec;
 
     typedef enum { NO_RESULT, CONFIG_READ, CONFIG_WRITTEN, FILE_NOT_FOUND, FILE_IDENT_WRONG } IORESULT;
 
-    list<record> records;  // contains the configurations from the configuration file
+    unordered_map<string,record> records;  // contains the configurations from the configuration file
 
     IORESULT ioresult = NO_RESULT;
 
+    bool dirty = false;  // true if the configuration differs from the configuration file
+
+    record *findRecord(string key);  // returns the record of a key or nullptr
+
   public:
     CfgAccess();
     byte setConfig(string fn);    // sets the filename of the configuration file
     byte readConfig();            // opens the configuration file and reads the configuration
-    byte writeConfig();           // writes the configuration to the configuration file
+    byte writeConfig();           // writes the configuration to the configuration file if it is modified
     string getValue(string key);  // returns the value of a key
-    byte setValue(string key, string value);  // sets the value of a key
+    int  getInt(string key, int defVal = 0);         // returns the value of a key as integer
+    bool getBool(string key, bool defVal = false);   // returns the value of a key as boolean
+    list<string> getStringList(string key);          // returns the value of a key as list of strings
+    byte setValue(string key, string value);         // sets the value of a key
+    byte setInt(string key, int value);              // sets the value of a key as integer
+    byte setBool(string key, bool value);            // sets the value of a key as boolean
+    byte setStringList(string key, list<string> value);  // sets the value of a key as list of strings
     byte removeKey(string key);   // removes a key from the configuration
+    bool isModified() { return dirty; }
 };
 
 #endif // CFGACCESS_H
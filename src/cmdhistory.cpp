@@ -0,0 +1,281 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <algorithm>
+#include "cmdhistory.h"
+
+/**
+ * @brief CmdHistory::CmdHistory
+ *   Constructor of the class CmdHistory.
+ */
+CmdHistory::CmdHistory()
+{
+    return;
+}
+
+/**
+ * @brief CmdHistory::setFile
+ *   Sets the filename of the history file and the maximum number of commands kept.
+ * @param fn
+ * @param max  maximum number of commands; 0 = default
+ * @return
+ */
+CmdHistory::byte CmdHistory::setFile(string fn, int max)
+{
+    filename = fn;
+
+    if (max > 0) maxEntries = max;
+
+    return 0;
+}
+
+/**
+ * @brief CmdHistory::load
+ *   Reads the history file and builds the trigram index. The file is read only once.
+ */
+void CmdHistory::load()
+{
+    string cmdLine;
+    ifstream instream;
+
+    if (loaded) return;
+
+    loaded = true;
+
+    instream.open(filename,ios::in);
+
+    if (instream) {
+        while (getline(instream,cmdLine)) {
+            // history file written under Windows?
+            if (!cmdLine.empty() && cmdLine.at(cmdLine.size()-1) == 13) {
+                cmdLine.erase(cmdLine.size()-1);
+            }
+            if (!cmdLine.empty()) {
+                entries.push_back(cmdLine);
+            }
+        }
+        instream.close();
+    }
+
+    // Too many commands in the history file? => the oldest commands are removed
+    if (entries.size() > maxEntries) {
+        entries.erase(entries.begin(),entries.begin()+(entries.size()-maxEntries));
+        compact();
+    }
+
+    for (size_t num = 0; num < entries.size(); num++) {
+        trigrams.add((int)num,entries.at(num));
+    }
+
+  #ifdef DEBUG
+    cout << "History loaded: " << entries.size() << " commands.\n";
+  #endif
+
+    return;
+}
+
+/**
+ * @brief CmdHistory::compact
+ *   Rewrites the history file with the commands kept in memory.
+ * @return
+ *   0 = file written
+ *   1 = could not write the temporary file
+ *   2 = could not replace the history file
+ */
+CmdHistory::byte CmdHistory::compact()
+{
+    string tmpname = filename + ".tmp";
+    ofstream outstream;
+
+    if (histstream.is_open()) histstream.close();
+
+    outstream.open(tmpname,ios::out|ios::trunc);
+
+    if (!outstream) return 1;
+
+    for (size_t num = 0; num < entries.size(); num++) {
+        outstream << entries.at(num) << '\n';
+    }
+
+    outstream.close();
+
+    if (outstream.fail()) {
+        remove(tmpname.c_str());
+        return 1;
+    }
+
+  #ifdef _WIN32
+    remove(filename.c_str());  // rename() doesn't replace an existing file under Windows
+  #endif
+
+    if (rename(tmpname.c_str(),filename.c_str()) != 0) {
+        remove(tmpname.c_str());
+        return 2;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief CmdHistory::append
+ *   Adds a command to the history. The command is appended to the history file
+ *   immediately, so the history isn't lost if the program is killed. A command
+ *   equal to the previous command isn't added again.
+ * @param cmd
+ * @return
+ *   0 = command added or equal to the previous command
+ *   1 = empty command
+ *   2 = could not write the history file
+ */
+CmdHistory::byte CmdHistory::append(string cmd)
+{
+    if (cmd.empty()) return 1;
+
+    load();
+
+    if (!entries.empty() && entries.back() == cmd) return 0;
+
+    entries.push_back(cmd);
+    trigrams.add((int)entries.size()-1,entries.back());
+
+    // The history exceeds the maximum by 10%? => the oldest commands are removed and the index is rebuilt
+    if (entries.size() > maxEntries + maxEntries/10) {
+        entries.erase(entries.begin(),entries.begin()+(entries.size()-maxEntries));
+        trigrams.clear();
+        for (size_t num = 0; num < entries.size(); num++) {
+            trigrams.add((int)num,entries.at(num));
+        }
+        return compact() ? 2 : 0;
+    }
+
+    if (!histstream.is_open()) {
+        histstream.open(filename,ios::out|ios::app);
+    }
+
+    if (!histstream) return 2;
+
+    histstream << cmd << '\n';
+    histstream.flush();
+
+    return 0;
+}
+
+/**
+ * @brief CmdHistory::size
+ * @return number of commands in the history
+ */
+int CmdHistory::size()
+{
+    load();
+
+    return (int)entries.size();
+}
+
+/**
+ * @brief CmdHistory::at
+ * @param num  number of the command; 0 = oldest command
+ * @return command; empty string if the number is out of range
+ */
+string CmdHistory::at(int num)
+{
+    load();
+
+    if (num < 0 || num >= (int)entries.size()) return string();
+
+    return entries.at(num);
+}
+
+/**
+ * @brief CmdHistory::search
+ *   Searches the next command matching the text starting at a number. Texts with three or more
+ *   characters are looked up in the index: only the commands containing the rarest trigram
+ *   of the text are compared.
+ * @param text
+ * @param start     number of the command the search starts at; the command itself isn't compared
+ * @param prefix    true = the command must start with the text; false = the command must contain the text
+ * @param backward  true = search the newest command before start; false = the oldest command after start
+ * @return number of the command; -1 = not found
+ */
+int CmdHistory::search(const string &text, int start, bool prefix, bool backward)
+{
+    load();
+
+    // short text => compare the commands directly
+    if (text.size() < TRIGRAMLENGTH) {
+        if (backward) {
+            if (start > (int)entries.size()) start = (int)entries.size();
+            for (int num = start-1; num >= 0; num--) {
+                const string &cmd = entries.at(num);
+                if (prefix ? cmd.compare(0,text.size(),text) == 0 : cmd.find(text) != string::npos) return num;
+            }
+        } else {
+            if (start < -1) start = -1;
+            for (int num = start+1; num < (int)entries.size(); num++) {
+                const string &cmd = entries.at(num);
+                if (prefix ? cmd.compare(0,text.size(),text) == 0 : cmd.find(text) != string::npos) return num;
+            }
+        }
+        return -1;
+    }
+
+    // only the commands containing the rarest trigram of the text are compared
+    const vector<int> *rarest = &trigrams.lookup(text);
+
+    vector<int>::const_iterator iter;
+
+    if (backward) {
+        // compare the commands containing the trigram from the newest to the oldest
+        iter = lower_bound(rarest->begin(),rarest->end(),start);
+        while (iter != rarest->begin()) {
+            --iter;
+            const string &cmd = entries.at(*iter);
+            if (prefix ? cmd.compare(0,text.size(),text) == 0 : cmd.find(text) != string::npos) return *iter;
+        }
+    } else {
+        // compare the commands containing the trigram from the oldest to the newest
+        for (iter = upper_bound(rarest->begin(),rarest->end(),start); iter != rarest->end(); ++iter) {
+            const string &cmd = entries.at(*iter);
+            if (prefix ? cmd.compare(0,text.size(),text) == 0 : cmd.find(text) != string::npos) return *iter;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief CmdHistory::findPrefix
+ * @param prefix
+ * @param start     number of the command the search starts at
+ * @param backward  true = search older commands; false = search newer commands
+ * @return number of the next command starting with the prefix; -1 = not found
+ */
+int CmdHistory::findPrefix(const string &prefix, int start, bool backward)
+{
+    return search(prefix,start,true,backward);
+}
+
+/**
+ * @brief CmdHistory::findText
+ * @param text
+ * @param start     number of the command the search starts at
+ * @param backward  true = search older commands; false = search newer commands
+ * @return number of the next command containing the text; -1 = not found
+ */
+int CmdHistory::findText(const string &text, int start, bool backward)
+{
+    return search(text,start,false,backward);
+}
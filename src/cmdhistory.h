@@ -0,0 +1,69 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef CMDHISTORY_H
+#define CMDHISTORY_H
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "main.h"
+#include "trigramindex.h"
+
+using namespace std;
+
+/**
+ * @brief CmdHistory
+ *   History of the commands entered in the terminal window. The history file is
+ *   read on the first access; new commands are appended to the file. Every command
+ *   is indexed by its trigrams, so the search for a substring only checks the
+ *   commands containing the rarest trigram of the substring.
+ */
+class CmdHistory
+{
+    typedef unsigned char byte;
+
+    fstream histstream;
+
+    string filename;
+
+    size_t maxEntries = 100000;  // maximum number of commands kept in the history file
+
+    bool loaded = false;  // true if the history file is read
+
+    vector<string> entries;  // commands; the newest command is the last entry
+
+    TrigramIndex trigrams;  // numbers of the commands by their trigrams
+
+    void load();                 // reads the history file and builds the index
+    byte compact();              // rewrites the history file with the newest commands only
+
+    int search(const string &text, int start, bool prefix, bool backward);  // returns the next matching command
+
+  public:
+    CmdHistory();
+    byte setFile(string fn, int max);  // sets the filename of the history file and the maximum number of commands
+    byte append(string cmd);           // adds a command to the history and to the history file
+    int  size();                       // number of commands
+    string at(int num);                // returns a command; 0 = oldest command
+    int  findPrefix(const string &prefix, int start, bool backward = true);  // next command starting with the prefix; -1 = none
+    int  findText(const string &text, int start, bool backward = true);      // next command containing the text; -1 = none
+};
+
+#endif // CMDHISTORY_H
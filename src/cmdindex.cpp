@@ -0,0 +1,173 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include "cmdindex.h"
+
+/**
+ * @brief CmdIndex::CmdIndex
+ *   Constructor of the class CmdIndex.
+ */
+CmdIndex::CmdIndex()
+{
+    return;
+}
+
+/**
+ * @brief CmdIndex::fold
+ * @param text
+ * @return text with lowercase ASCII letters
+ */
+string CmdIndex::fold(const string &text)
+{
+    string folded(text);
+
+    for (size_t pos = 0; pos < folded.size(); pos++) {
+        if (folded[pos] >= 'A' && folded[pos] <= 'Z') folded[pos]+= 32;
+    }
+
+    return folded;
+}
+
+/**
+ * @brief CmdIndex::compact
+ *   Removes the deleted entries and rebuilds the trigrams with the new numbers.
+ */
+void CmdIndex::compact()
+{
+    vector<Entry> kept;
+
+    kept.reserve(entries.size()-removedEntries);
+
+    for (size_t num = 0; num < entries.size(); num++) {
+        if (!entries[num].removed) kept.push_back(entries[num]);
+    }
+
+    entries.swap(kept);
+    numbers.clear();
+    trigrams.clear();
+    removedEntries = 0;
+
+    for (size_t num = 0; num < entries.size(); num++) {
+        numbers[entries[num].category+'\n'+entries[num].command] = (int)num;
+        trigrams.add((int)num,entries[num].folded);
+    }
+
+    return;
+}
+
+/**
+ * @brief CmdIndex::add
+ *   Adds a command of a category. A command already contained isn't added again.
+ * @param cat
+ * @param cmd
+ */
+void CmdIndex::add(const string &cat, const string &cmd)
+{
+    lock_guard<mutex> locker(indexMutex);
+
+    string key = cat+'\n'+cmd;
+
+    if (numbers.count(key)) return;
+
+    Entry entry;
+
+    entry.category = cat;
+    entry.command  = cmd;
+    entry.folded   = fold(cmd)+'\n'+fold(cat);
+
+    entries.push_back(entry);
+    numbers[key] = (int)entries.size()-1;
+    trigrams.add((int)entries.size()-1,entries.back().folded);
+
+    return;
+}
+
+/**
+ * @brief CmdIndex::remove
+ *   Marks a command as deleted. More than half of the entries deleted => the index is compacted.
+ * @param cat
+ * @param cmd
+ */
+void CmdIndex::remove(const string &cat, const string &cmd)
+{
+    lock_guard<mutex> locker(indexMutex);
+
+    unordered_map<string,int>::iterator iter = numbers.find(cat+'\n'+cmd);
+
+    if (iter == numbers.end()) return;
+
+    entries[iter->second].removed = true;
+    numbers.erase(iter);
+    removedEntries++;
+
+    if (removedEntries > entries.size()/2) compact();
+
+    return;
+}
+
+/**
+ * @brief CmdIndex::clear
+ */
+void CmdIndex::clear()
+{
+    lock_guard<mutex> locker(indexMutex);
+
+    entries.clear();
+    numbers.clear();
+    trigrams.clear();
+    removedEntries = 0;
+
+    return;
+}
+
+/**
+ * @brief CmdIndex::search
+ *   Searches the commands whose text or category contains the text; upper and lower case
+ *   letters are equal. Texts with three or more characters are looked up in the index.
+ * @param text
+ * @param max   maximum number of matches
+ * @return matches in the order the commands were added
+ */
+vector<CmdIndex::Match> CmdIndex::search(const string &text, size_t max) const
+{
+    vector<Match> matches;
+    string folded = fold(text);
+
+    lock_guard<mutex> locker(indexMutex);
+
+    if (folded.empty()) return matches;
+
+    // short text => compare the entries directly
+    if (folded.size() < TRIGRAMLENGTH) {
+        for (size_t num = 0; num < entries.size() && matches.size() < max; num++) {
+            if (entries[num].removed || entries[num].folded.find(folded) == string::npos) continue;
+            matches.push_back({ entries[num].category, entries[num].command });
+        }
+        return matches;
+    }
+
+    // only the entries containing the rarest trigram of the text are compared
+    const vector<int> *rarest = &trigrams.lookup(folded);
+
+    for (size_t idx = 0; idx < rarest->size() && matches.size() < max; idx++) {
+        const Entry &entry = entries[(*rarest)[idx]];
+        if (entry.removed || entry.folded.find(folded) == string::npos) continue;
+        matches.push_back({ entry.category, entry.command });
+    }
+
+    return matches;
+}
@@ -0,0 +1,69 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef CMDINDEX_H
+#define CMDINDEX_H
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "trigramindex.h"
+
+using namespace std;
+
+/**
+ * @brief CmdIndex
+ *   Index of the commands of the library for the filter across all categories. Every
+ *   command is indexed with its category by the trigrams of the lowercase text, so a
+ *   filter text only checks the commands containing its rarest trigram. Deleted commands
+ *   are marked and removed when the index is compacted. The index is updated by DBAccess
+ *   and searched by the thread of the filter; a mutex protects it.
+ */
+class CmdIndex
+{
+    struct Entry {
+        string category;
+        string command;
+        string folded;        // lowercase command and category separated by '\n'
+        bool   removed = false;
+    };
+
+    vector<Entry> entries;
+    unordered_map<string,int> numbers;              // category '\n' command -> number of the entry
+    TrigramIndex trigrams;                          // numbers of the entries by their trigrams
+    size_t removedEntries = 0;
+
+    mutable mutex indexMutex;
+
+    void compact();                      // removes the deleted entries and rebuilds the trigrams
+    static string fold(const string &text);
+
+  public:
+    struct Match {
+        string category;
+        string command;
+    };
+
+    CmdIndex();
+    void add(const string &cat, const string &cmd);
+    void remove(const string &cat, const string &cmd);
+    void clear();
+    vector<Match> search(const string &text, size_t max) const;  // commands or categories containing the text
+};
+
+#endif // CMDINDEX_H
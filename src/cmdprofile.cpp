@@ -0,0 +1,77 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include "cmdprofile.h"
+
+/**
+ * @brief CmdProfile::CmdProfile
+ *   Constructor of the class CmdProfile.
+ */
+CmdProfile::CmdProfile()
+{
+    return;
+}
+
+/**
+ * @brief CmdProfile::add
+ *   Adds the duration of an execution of a command. If all samples are used,
+ *   the oldest duration is replaced.
+ * @param cmd
+ * @param seconds
+ */
+void CmdProfile::add(string cmd, double seconds)
+{
+    record &rec = records[cmd];
+
+    rec.count++;
+
+    if (rec.durations.size() < PROFILESAMPLES) {
+        rec.durations.push_back(seconds);
+    } else {
+        rec.durations[rec.next] = seconds;
+        rec.next = (rec.next + 1) % PROFILESAMPLES;
+    }
+
+    return;
+}
+
+/**
+ * @brief CmdProfile::get
+ *   Determines the aggregates of a command. The percentiles are the nearest rank
+ *   of the kept durations.
+ * @param cmd
+ * @param count  number of executions
+ * @param p50    median of the durations in seconds
+ * @param p95    95th percentile of the durations in seconds
+ * @return false = command not executed yet
+ */
+bool CmdProfile::get(string cmd, long &count, double &p50, double &p95)
+{
+    unordered_map<string,record>::iterator iter = records.find(cmd);
+
+    if (iter == records.end()) return false;
+
+    vector<double> sorted = iter->second.durations;
+
+    sort(sorted.begin(),sorted.end());
+
+    count = iter->second.count;
+    p50   = sorted.at((sorted.size()*50 + 99)/100 - 1);
+    p95   = sorted.at((sorted.size()*95 + 99)/100 - 1);
+
+    return true;
+}
@@ -0,0 +1,54 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef CMDPROFILE_H
+#define CMDPROFILE_H
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "main.h"
+
+using namespace std;
+
+/**
+ * @brief CmdProfile
+ *   Aggregates the durations of the executed commands. For every command line the
+ *   number of executions and the last PROFILESAMPLES durations are kept, from which
+ *   the median and the 95th percentile are determined.
+ */
+class CmdProfile
+{
+    #define PROFILESAMPLES 1000  // maximum number of durations kept per command
+
+    // structure of the aggregates of a command
+    struct record {
+        long   count = 0;       // number of executions
+        size_t next  = 0;       // position of the next duration if all samples are used
+        vector<double> durations;
+    };
+
+    unordered_map<string,record> records;
+
+  public:
+    CmdProfile();
+    void add(string cmd, double seconds);  // adds the duration of an execution of a command
+    bool get(string cmd, long &count, double &p50, double &p95);  // returns the aggregates of a command
+};
+
+#endif // CMDPROFILE_H
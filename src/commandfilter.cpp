@@ -0,0 +1,106 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include "commandfilter.h"
+
+/**
+ * @brief CommandFilter::CommandFilter
+ *   Constructor of the class CommandFilter. The thread searching the index is started.
+ * @param idx     index of the commands
+ * @param parent
+ */
+CommandFilter::CommandFilter(const CmdIndex *idx, QObject *parent) : QThread(parent)
+{
+    index = idx;
+
+    start(QThread::LowPriority);
+
+    return;
+}
+
+/**
+ * @brief CommandFilter::~CommandFilter
+ *   Destructor of the class CommandFilter. A running search is finished before the thread ends.
+ */
+CommandFilter::~CommandFilter()
+{
+    {
+        QMutexLocker locker(&filterMutex);
+        stopping = true;
+        filterCond.wakeOne();
+    }
+
+    wait();
+
+    return;
+}
+
+/**
+ * @brief CommandFilter::filter
+ *   Queues a filter text. A text queued before and not yet searched is replaced.
+ * @param text
+ */
+void CommandFilter::filter(const QString &text)
+{
+    QMutexLocker locker(&filterMutex);
+
+    pending = text;
+    queued  = true;
+    filterCond.wakeOne();
+
+    return;
+}
+
+/**
+ * @brief CommandFilter::run
+ *   Searches the queued filter texts and sends the matching commands with their categories.
+ */
+void CommandFilter::run()
+{
+    QString text;
+    vector<CmdIndex::Match> matches;
+
+    for (;;) {
+        {
+            QMutexLocker locker(&filterMutex);
+            while (!queued && !stopping) {
+                filterCond.wait(&filterMutex);
+            }
+            if (stopping) break;
+            text   = pending;
+            queued = false;
+        }
+
+        matches = index->search(text.toStdString(),FILTERMAXRESULTS);
+
+        QStringList categories;
+        QStringList commands;
+
+        for (size_t idx = 0; idx < matches.size(); idx++) {
+            categories << QString::fromStdString(matches[idx].category);
+            commands << QString::fromStdString(matches[idx].command);
+        }
+
+      #ifdef DEBUG
+        cout << "Filter \"" << text.toStdString() << "\": " << matches.size() << " commands.\n";
+      #endif
+
+        emit results_signal(text,categories,commands);
+    }
+
+    return;
+}
@@ -0,0 +1,64 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef COMMANDFILTER_H
+#define COMMANDFILTER_H
+
+#include <iostream>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+#include <QWaitCondition>
+#include "cmdindex.h"
+#include "main.h"
+
+/**
+ * @brief CommandFilter
+ *   Searches the commands of all categories for the filter of the main window. The
+ *   search runs in the thread of the class, so typing in the filter never waits for
+ *   it. Only the newest filter text is searched; texts entered during a search replace
+ *   each other.
+ */
+class CommandFilter : public QThread
+{
+    Q_OBJECT
+
+    #define FILTERMAXRESULTS 200  // maximum number of commands shown for a filter text
+
+    const CmdIndex *index;
+
+    QMutex         filterMutex;   // protects pending, queued and stopping
+    QWaitCondition filterCond;
+    QString pending;              // newest filter text not yet searched
+    bool    queued   = false;
+    bool    stopping = false;
+
+    void run() override;
+
+  public:
+    explicit CommandFilter(const CmdIndex *idx, QObject *parent = nullptr);
+    ~CommandFilter();
+
+    void filter(const QString &text);  // queues a filter text for the search
+
+  signals:
+    void results_signal(QString text, QStringList categories, QStringList commands);
+};
+
+#endif // COMMANDFILTER_H
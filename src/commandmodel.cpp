@@ -0,0 +1,209 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include "commandmodel.h"
+
+/**
+ * @brief CommandModel::CommandModel
+ *   Constructor of the class CommandModel.
+ * @param db      data records of the command library
+ * @param parent
+ */
+CommandModel::CommandModel(DBAccess *db, QObject *parent) : QAbstractListModel(parent)
+{
+    dbAccess = db;
+
+    dbAccess->addListener(this);
+
+    return;
+}
+
+/**
+ * @brief CommandModel::~CommandModel
+ *   Destructor of the class CommandModel.
+ */
+CommandModel::~CommandModel()
+{
+    dbAccess->removeListener(this);
+
+    return;
+}
+
+/**
+ * @brief CommandModel::rowCount
+ * @param parent
+ * @return number of commands of the category
+ */
+int CommandModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) return 0;
+
+    return dbAccess->cmdCount(category);
+}
+
+/**
+ * @brief CommandModel::data
+ * @param index
+ * @param role
+ * @return command
+ */
+QVariant CommandModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || (role != Qt::DisplayRole && role != Qt::EditRole)) return QVariant();
+
+    return QString::fromStdString(dbAccess->cmdAt(category,index.row()));
+}
+
+/**
+ * @brief CommandModel::setCategory
+ *   Displays the commands of another category. The views are reset; they read only
+ *   the visible commands.
+ * @param cat  number of the category; -1 = none
+ */
+void CommandModel::setCategory(int cat)
+{
+    beginResetModel();
+    category = (cat >= 0 && cat < dbAccess->catCount()) ? cat : -1;
+    endResetModel();
+
+    return;
+}
+
+/**
+ * @brief CommandModel::recordAboutToBeAdded
+ *   Starts inserting the row of a command added to the displayed category.
+ * @param cat
+ * @param num
+ * @param newCat
+ */
+void CommandModel::recordAboutToBeAdded(int cat, int num, bool newCat)
+{
+    Q_UNUSED(newCat);
+
+    inserting = (cat == category);
+
+    if (inserting) {
+        beginInsertRows(QModelIndex(),num,num);
+    }
+
+    return;
+}
+
+/**
+ * @brief CommandModel::recordAdded
+ *   Finishes inserting the row of a command added to the displayed category.
+ * @param cat
+ * @param num
+ * @param newCat
+ */
+void CommandModel::recordAdded(int cat, int num, bool newCat)
+{
+    Q_UNUSED(cat);
+    Q_UNUSED(num);
+    Q_UNUSED(newCat);
+
+    if (inserting) {
+        inserting = false;
+        endInsertRows();
+    }
+
+    return;
+}
+
+/**
+ * @brief CommandModel::recordChanged
+ *   Updates the row of a modified command of the displayed category.
+ * @param cat
+ * @param num
+ */
+void CommandModel::recordChanged(int cat, int num)
+{
+    if (cat == category) {
+        emit dataChanged(index(num),index(num));
+    }
+
+    return;
+}
+
+/**
+ * @brief CommandModel::recordAboutToBeRemoved
+ *   Starts removing the row of a deleted command of the displayed category.
+ * @param cat
+ * @param num
+ * @param lastCmd
+ */
+void CommandModel::recordAboutToBeRemoved(int cat, int num, bool lastCmd)
+{
+    Q_UNUSED(lastCmd);
+
+    removing = (cat == category);
+
+    if (removing) {
+        beginRemoveRows(QModelIndex(),num,num);
+    }
+
+    return;
+}
+
+/**
+ * @brief CommandModel::recordRemoved
+ *   Finishes removing the row of a deleted command. If the displayed category was
+ *   removed, its number refers to the next category now, so no category is displayed
+ *   before the views read the rows again; the following categories are renumbered.
+ * @param cat
+ * @param num
+ * @param lastCmd
+ */
+void CommandModel::recordRemoved(int cat, int num, bool lastCmd)
+{
+    Q_UNUSED(num);
+
+    if (removing) {
+        removing = false;
+        if (lastCmd) category = -1;
+        endRemoveRows();
+    } else if (lastCmd && cat < category) {
+        category--;
+    }
+
+    return;
+}
+
+/**
+ * @brief CommandModel::recordsAboutToBeReset
+ *   Starts resetting the views before the data records are read, cleared or sorted.
+ */
+void CommandModel::recordsAboutToBeReset()
+{
+    beginResetModel();
+
+    return;
+}
+
+/**
+ * @brief CommandModel::recordsReset
+ *   Finishes resetting the views. The number of the category is kept if the category
+ *   still exists.
+ */
+void CommandModel::recordsReset()
+{
+    if (category >= dbAccess->catCount()) category = -1;
+
+    endResetModel();
+
+    return;
+}
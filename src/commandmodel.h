@@ -0,0 +1,63 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef COMMANDMODEL_H
+#define COMMANDMODEL_H
+
+#include <QAbstractListModel>
+#include <QModelIndex>
+#include <QString>
+#include <QVariant>
+#include "dbaccess.h"
+#include "main.h"
+
+/**
+ * @brief CommandModel
+ *   List model of the commands of one category of the command library. The commands
+ *   are read from the index of DBAccess when a view displays them, so switching the
+ *   category doesn't copy the commands. As listener of DBAccess the model updates the
+ *   changed rows of the displayed category only.
+ */
+class CommandModel : public QAbstractListModel, public DBAccess::Listener
+{
+    Q_OBJECT
+
+    DBAccess *dbAccess;
+
+    int  category  = -1;     // number of the displayed category; -1 = none
+    bool inserting = false;  // a row is inserted between the notifications of DBAccess
+    bool removing  = false;  // a row is removed between the notifications of DBAccess
+
+  public:
+    explicit CommandModel(DBAccess *db, QObject *parent = nullptr);
+    ~CommandModel();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    void setCategory(int cat);     // displays the commands of a category
+
+    void recordAboutToBeAdded(int cat, int num, bool newCat) override;
+    void recordAdded(int cat, int num, bool newCat) override;
+    void recordChanged(int cat, int num) override;
+    void recordAboutToBeRemoved(int cat, int num, bool lastCmd) override;
+    void recordRemoved(int cat, int num, bool lastCmd) override;
+    void recordsAboutToBeReset() override;
+    void recordsReset() override;
+};
+
+#endif // COMMANDMODEL_H
@@ -80,6 +80,10 @@ DBAccess::byte DBAccess::read()
 
     list<string> recCmd;
 
+    for (size_t idx = 0; idx < listeners.size(); idx++) {
+        listeners[idx]->recordsAboutToBeReset();
+    }
+
     // reset the data records list
     records.clear();
 
@@ -108,6 +112,12 @@ DBAccess::byte DBAccess::read()
 
     } while (!recCmd.empty());
 
+    buildIndex();
+
+    for (size_t idx = 0; idx < listeners.size(); idx++) {
+        listeners[idx]->recordsReset();
+    }
+
     return result;
 }
 
@@ -125,12 +135,20 @@ DBAccess::byte DBAccess::write()
 
     list<string>::size_type size_notes;
 
-    // sort the data records
-    cmdsSort();
+    vector<iterRec> sorted;
+
+    // the data records are written sorted; the order of the records list displayed isn't changed
+    sorted.reserve(records.size());
 
     for (iterRec ptr = records.begin(); ptr != records.end(); ptr++) {
+        sorted.push_back(ptr);
+    }
+
+    stable_sort(sorted.begin(),sorted.end(),[](const iterRec &rec1, const iterRec &rec2) { return recLess(*rec1,*rec2); });
+
+    for (size_t num = 0; num < sorted.size(); num++) {
 
-        rec = *ptr;
+        rec = *sorted[num];
 
         size_notes   = rec.notes.size();
         int size_val = (int)size_notes;
@@ -197,8 +215,18 @@ DBAccess::byte DBAccess::clear()
 {
     byte result = 0;
 
+    for (size_t idx = 0; idx < listeners.size(); idx++) {
+        listeners[idx]->recordsAboutToBeReset();
+    }
+
     records.clear();  // clear all data records from the data records list
 
+    buildIndex();
+
+    for (size_t idx = 0; idx < listeners.size(); idx++) {
+        listeners[idx]->recordsReset();
+    }
+
     return result;
 }
 
@@ -209,19 +237,7 @@ DBAccess::byte DBAccess::clear()
  */
 list<string> DBAccess::catRead()
 {
-    list<string> catLst;
-
-    for (iterRec ptrRec = records.begin(); ptrRec!= records.end(); ptrRec++) {
-
-        string cat = (*ptrRec).category;
-
-        // write categories only once to the category list
-        iterStr ptrStr = find(catLst.begin(),catLst.end(),cat);
-
-        if (ptrStr == catLst.end()) {
-            catLst.push_back(cat);
-        }
-    }
+    list<string> catLst(catNames.begin(),catNames.end());
 
     return catLst;
 }
@@ -236,11 +252,10 @@ list<string> DBAccess::cmdRead(string cat)
 {
     list<string> cmdLst;
 
-    for (iterRec ptrRec = records.begin(); ptrRec!= records.end(); ptrRec++) {
+    int catNum = catFind(cat);
 
-        if ((*ptrRec).category == cat) {
-            cmdLst.push_back((*ptrRec).command);
-        }
+    for (int num = 0; num < cmdCount(catNum); num++) {
+        cmdLst.push_back(catRecords[catNum][num]->command);
     }
 
     return cmdLst;
@@ -257,17 +272,10 @@ list<string> DBAccess::ntsRead(string cat, string cmd)
 {
     list<string> notes;
 
-    int numRec = recFind(cat,cmd);
+    iterRec iter = recLookup(cat,cmd);
 
     // Data record found?
-    if (numRec >= 0) {
-
-        iterRec iter = records.begin();
-
-        for (int cntr = 0; cntr < numRec; cntr++) {
-            iter++;
-        }
-
+    if (iter != records.end()) {
         notes = iter->notes;
     }
 
@@ -297,8 +305,34 @@ DBAccess::byte DBAccess::cmdAdd(list<string> cmd)
         rec.notes.pop_back();
     }
 
+    // number of the category and of the command the new data record gets
+    int  catNum = catFind(rec.category);
+    bool newCat = catNum < 0;
+    int  cmdNum = newCat ? 0 : (int)catRecords[catNum].size();
+
+    if (newCat) catNum = (int)catNames.size();
+
+    for (size_t idx = 0; idx < listeners.size(); idx++) {
+        listeners[idx]->recordAboutToBeAdded(catNum,cmdNum,newCat);
+    }
+
     records.push_back(rec);
 
+    // the index of the category refers to the new data record
+    if (newCat) {
+        catNumbers.emplace(rec.category,catNum);
+        catNames.push_back(rec.category);
+        catRecords.emplace_back();
+    }
+
+    catRecords[catNum].push_back(prev(records.end()));
+
+    searchIndex.add(rec.category,rec.command);
+
+    for (size_t idx = 0; idx < listeners.size(); idx++) {
+        listeners[idx]->recordAdded(catNum,cmdNum,newCat);
+    }
+
     return result;
 }
 
@@ -327,20 +361,25 @@ DBAccess::byte DBAccess::cmdModify(list<string> cmd)
         notes.clear();
     }
 
-    int numRec = recFind(cat,cmdOld);
+    int catNum = catFind(cat);
+    int cmdNum = cmdFind(catNum,cmdOld);
 
     // Data record found?
-    if (numRec >= 0) {
-
-        iterRec ptrRec = records.begin();
+    if (cmdNum >= 0) {
 
-        for (int cntr = 0; cntr < numRec; cntr++) {
-            ptrRec++;
-        }
+        iterRec ptrRec = catRecords[catNum][cmdNum];
 
         (*ptrRec).command = cmdNew;
         (*ptrRec).notes   = notes;
 
+        // Another data record with the old command? => the old command remains in the index
+        if (cmdFind(catNum,cmdOld) < 0) searchIndex.remove(cat,cmdOld);
+        searchIndex.add(cat,cmdNew);
+
+        for (size_t idx = 0; idx < listeners.size(); idx++) {
+            listeners[idx]->recordChanged(catNum,cmdNum);
+        }
+
     } else {
         result = 1;
     }
@@ -363,19 +402,41 @@ DBAccess::byte DBAccess::cmdDelete(list<string> cmd)
     string cmdDel = cmd.front();
     cmd.pop_front();
 
-    int numRec = recFind(cat,cmdDel);
+    int catNum = catFind(cat);
+    int cmdNum = cmdFind(catNum,cmdDel);
 
     // Data record found?
-    if (numRec >= 0) {
+    if (cmdNum >= 0) {
 
-        iterRec ptrRec = records.begin();
+        vector<iterRec> &recs = catRecords[catNum];
+        iterRec ptrRec = recs[cmdNum];
+        bool    lastCmd = recs.size() == 1;
 
-        for (int cntr = 0; cntr < numRec; cntr++) {
-            ptrRec++;
+        for (size_t idx = 0; idx < listeners.size(); idx++) {
+            listeners[idx]->recordAboutToBeRemoved(catNum,cmdNum,lastCmd);
+        }
+
+        recs.erase(recs.begin()+cmdNum);
+
+        // Last command of the category deleted? => the following categories are renumbered
+        if (lastCmd) {
+            catNames.erase(catNames.begin()+catNum);
+            catRecords.erase(catRecords.begin()+catNum);
+            catNumbers.erase(cat);
+            for (int num = catNum; num < (int)catNames.size(); num++) {
+                catNumbers[catNames[num]] = num;
+            }
         }
 
         records.erase(ptrRec);
 
+        // Another data record with the same command? => the command remains in the index
+        if (lastCmd || cmdFind(catNum,cmdDel) < 0) searchIndex.remove(cat,cmdDel);
+
+        for (size_t idx = 0; idx < listeners.size(); idx++) {
+            listeners[idx]->recordRemoved(catNum,cmdNum,lastCmd);
+        }
+
     } else {
         result = 1;
     }
@@ -413,66 +474,200 @@ int DBAccess::recFind(string cat, string cmd)
 
 /**
  * @brief DBAccess::cmdsSort
- *   Sorts the database.
+ *   Sorts the database by category and command. The sort is stable and relinks the
+ *   data records instead of copying them.
  * @return
  */
 DBAccess::byte DBAccess::cmdsSort()
 {
-    byte   result = 0;
-    record swapRec;
-
-    iterRec iter1 = records.begin();
-    iterRec iter2;
-
-    // first sort the commands of the data records
-    for (int idx1 = 0; idx1 < ((int)records.size()-1); idx1++) {
-        iter2 = iter1;
-        for (int idx2 = idx1+1; idx2 < (int)records.size(); idx2++) {
-            iter2++;
-            // Command of data record 2 < command of data record 1?
-            if (iter2->command < iter1->command) {
-              // swap the data records
-                swapRec.command  = iter1->command;
-                swapRec.category = iter1->category;
-                swapRec.notes    = iter1->notes;
-              //..
-                iter1->command  = iter2->command;
-                iter1->category = iter2->category;
-                iter1->notes    = iter2->notes;
-              //..
-                iter2->command  = swapRec.command;
-                iter2->category = swapRec.category;
-                iter2->notes    = swapRec.notes;
-            }
-        }
-        iter1++;
+    byte result = 0;
+
+    for (size_t idx = 0; idx < listeners.size(); idx++) {
+        listeners[idx]->recordsAboutToBeReset();
     }
 
-    // then sort the categories of the data records
-    iter1 = records.begin();
-
-    for (int idx1 = 0; idx1 < ((int)records.size()-1); idx1++) {
-        iter2 = iter1;
-        for (int idx2 = idx1+1; idx2 < (int)records.size(); idx2++) {
-            iter2++;
-            // Category of data record 2 < category of data record 1?
-            if (iter2->category < iter1->category) {
-              // swap the data records
-                swapRec.command  = iter1->command;
-                swapRec.category = iter1->category;
-                swapRec.notes    = iter1->notes;
-              //..
-                iter1->command  = iter2->command;
-                iter1->category = iter2->category;
-                iter1->notes    = iter2->notes;
-              //..
-                iter2->command  = swapRec.command;
-                iter2->category = swapRec.category;
-                iter2->notes    = swapRec.notes;
-            }
-        }
-        iter1++;
+    records.sort(recLess);
+
+    buildIndex();
+
+    for (size_t idx = 0; idx < listeners.size(); idx++) {
+        listeners[idx]->recordsReset();
     }
 
     return result;
 }
+
+/**
+ * @brief DBAccess::recLess
+ *   Order of the data records in the database: by category, then by command.
+ * @param rec1
+ * @param rec2
+ * @return true = rec1 is in front of rec2
+ */
+bool DBAccess::recLess(const record &rec1, const record &rec2)
+{
+    if (rec1.category != rec2.category) return rec1.category < rec2.category;
+
+    return rec1.command < rec2.command;
+}
+
+/**
+ * @brief DBAccess::buildIndex
+ *   Indexes the data records by their categories. The categories are numbered in the
+ *   order of their first data record. The index of the filter is rebuilt too.
+ */
+void DBAccess::buildIndex()
+{
+    catNames.clear();
+    catRecords.clear();
+    catNumbers.clear();
+    searchIndex.clear();
+
+    for (iterRec ptrRec = records.begin(); ptrRec != records.end(); ptrRec++) {
+        unordered_map<string,int>::iterator iter = catNumbers.find(ptrRec->category);
+        if (iter == catNumbers.end()) {
+            iter = catNumbers.emplace(ptrRec->category,(int)catNames.size()).first;
+            catNames.push_back(ptrRec->category);
+            catRecords.emplace_back();
+        }
+        catRecords[iter->second].push_back(ptrRec);
+        searchIndex.add(ptrRec->category,ptrRec->command);
+    }
+
+    return;
+}
+
+/**
+ * @brief DBAccess::recLookup
+ *   Finds the data record of a command by the index of its category.
+ * @param cat  category
+ * @param cmd  command
+ * @return data record; records.end() = not found
+ */
+DBAccess::iterRec DBAccess::recLookup(const string &cat, const string &cmd)
+{
+    int catNum = catFind(cat);
+
+    if (catNum < 0) return records.end();
+
+    const vector<iterRec> &recs = catRecords[catNum];
+
+    for (size_t num = 0; num < recs.size(); num++) {
+        if (recs[num]->command == cmd) return recs[num];
+    }
+
+    return records.end();
+}
+
+/**
+ * @brief DBAccess::catCount
+ * @return number of categories
+ */
+int DBAccess::catCount() const
+{
+    return (int)catNames.size();
+}
+
+/**
+ * @brief DBAccess::catAt
+ * @param cat  number of the category
+ * @return name of the category; empty string if the number is out of range
+ */
+const string &DBAccess::catAt(int cat) const
+{
+    static const string empty;
+
+    if (cat < 0 || cat >= (int)catNames.size()) return empty;
+
+    return catNames[cat];
+}
+
+/**
+ * @brief DBAccess::catFind
+ * @param cat  name of the category
+ * @return number of the category; -1 = not found
+ */
+int DBAccess::catFind(const string &cat) const
+{
+    unordered_map<string,int>::const_iterator iter = catNumbers.find(cat);
+
+    return (iter == catNumbers.end()) ? -1 : iter->second;
+}
+
+/**
+ * @brief DBAccess::cmdCount
+ * @param cat  number of the category
+ * @return number of commands of the category; 0 if the number is out of range
+ */
+int DBAccess::cmdCount(int cat) const
+{
+    if (cat < 0 || cat >= (int)catRecords.size()) return 0;
+
+    return (int)catRecords[cat].size();
+}
+
+/**
+ * @brief DBAccess::cmdAt
+ * @param cat  number of the category
+ * @param num  number of the command in the category
+ * @return command; empty string if a number is out of range
+ */
+const string &DBAccess::cmdAt(int cat, int num) const
+{
+    static const string empty;
+
+    if (cat < 0 || cat >= (int)catRecords.size() || num < 0 || num >= (int)catRecords[cat].size()) return empty;
+
+    return catRecords[cat][num]->command;
+}
+
+/**
+ * @brief DBAccess::cmdFind
+ * @param cat  number of the category
+ * @param cmd  command
+ * @return number of the command in the category; -1 = not found
+ */
+int DBAccess::cmdFind(int cat, const string &cmd) const
+{
+    for (int num = 0; num < cmdCount(cat); num++) {
+        if (catRecords[cat][num]->command == cmd) return num;
+    }
+
+    return -1;
+}
+
+/**
+ * @brief DBAccess::addListener
+ *   Registers an object notified after every change of the data records.
+ * @param listener
+ */
+void DBAccess::addListener(Listener *listener)
+{
+    if (std::find(listeners.begin(),listeners.end(),listener) == listeners.end()) {
+        listeners.push_back(listener);
+    }
+
+    return;
+}
+
+/**
+ * @brief DBAccess::removeListener
+ * @param listener
+ */
+void DBAccess::removeListener(Listener *listener)
+{
+    listeners.erase(std::remove(listeners.begin(),listeners.end(),listener),listeners.end());
+
+    return;
+}
+
+/**
+ * @brief DBAccess::cmdIndex
+ *   Index of the commands of all categories. The index is thread-safe, so the filter
+ *   searches it in its own thread.
+ * @return
+ */
+const CmdIndex &DBAccess::cmdIndex() const
+{
+    return searchIndex;
+}
@@ -22,12 +22,23 @@
 #include <iostream>
 #include <list>
 #include <string>
+#include <unordered_map>
+#include <vector>
+#include "cmdindex.h"
 #include "dbconnect.h"
 #include "dbtext.h"
 #include "dbsqlite.h"
 
 using namespace std;
 
+/**
+ * @brief DBAccess
+ *   Data records of the command library. The records of every category are indexed
+ *   in the order of the records list, so the categories and the commands of a category
+ *   are accessed by their numbers without walking the list. Listeners are notified of
+ *   every change, so the views update only the affected rows. The commands of all
+ *   categories are indexed for the filter too.
+ */
 class DBAccess
 {
     typedef unsigned char byte;
@@ -44,8 +55,43 @@ class DBAccess
 
     list<record> records;  // contains the data records from the database
 
+    vector<string>          catNames;    // categories in the order of their first data record
+    vector<vector<iterRec>> catRecords;  // data records of each category in the order of the list
+    unordered_map<string,int> catNumbers;  // category -> number of the category
+
+    CmdIndex searchIndex;  // commands of all categories for the filter
+
     DBConnect *dbConnect;
 
+  public:
+    /**
+     * @brief Listener
+     *   Interface of the objects notified of changes of the data records. The numbers are
+     *   the number of the category and the number of the command in the category. Insertions,
+     *   removals and resets are notified before and after the change, so item models can
+     *   enclose the change in their begin and end calls. A listener overrides the
+     *   notifications it needs only.
+     */
+    class Listener
+    {
+      public:
+        virtual ~Listener() {}
+        virtual void recordAboutToBeAdded(int /*cat*/, int /*num*/, bool /*newCat*/) {}
+        virtual void recordAdded(int /*cat*/, int /*num*/, bool /*newCat*/) {}         // newCat = first command of a new category
+        virtual void recordChanged(int /*cat*/, int /*num*/) {}                        // command or notes modified
+        virtual void recordAboutToBeRemoved(int /*cat*/, int /*num*/, bool /*lastCmd*/) {}
+        virtual void recordRemoved(int /*cat*/, int /*num*/, bool /*lastCmd*/) {}      // lastCmd = the category was removed too
+        virtual void recordsAboutToBeReset() {}
+        virtual void recordsReset() {}                                                 // data records read, cleared or sorted
+    };
+
+  private:
+    vector<Listener *> listeners;
+
+    void buildIndex();                             // indexes the data records by their categories
+    iterRec recLookup(const string &cat, const string &cmd);  // returns the data record of a command; records.end() = not found
+    static bool recLess(const record &rec1, const record &rec2);  // order of the data records in the database
+
   public:
     DBAccess();
     byte openRead(string fn);          // opens the database for reading data records
@@ -63,6 +109,15 @@ class DBAccess
     byte cmdDelete(list<string> cmd);  // deletes a command from the database
     int  recFind(string cat, string cmd);  // finds a command in the database
     byte cmdsSort();                   // sorts the database
+    int  catCount() const;             // number of categories
+    const string &catAt(int cat) const;            // name of a category
+    int  catFind(const string &cat) const;         // number of a category; -1 = not found
+    int  cmdCount(int cat) const;                  // number of commands of a category
+    const string &cmdAt(int cat, int num) const;   // command of a category
+    int  cmdFind(int cat, const string &cmd) const;  // number of a command in its category; -1 = not found
+    void addListener(Listener *listener);          // notifies the listener of the changes
+    void removeListener(Listener *listener);
+    const CmdIndex &cmdIndex() const;              // index of the commands for the filter
 };
 
 #endif // DBACCESS_H
@@ -0,0 +1,132 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include "findbar.h"
+
+/**
+ * @brief FindBar::FindBar
+ *   Constructor of the class FindBar. The bar is hidden until open() is called.
+ * @param parent
+ */
+FindBar::FindBar(QWidget *parent) : QFrame(parent)
+{
+    setFrameShape(QFrame::StyledPanel);
+    setAutoFillBackground(true);
+
+    QBoxLayout *findLayout = new QBoxLayout(QBoxLayout::LeftToRight,this);
+
+    findLayout->setContentsMargins(4,2,4,2);
+
+    findLine    = new QLineEdit(this);
+    hitsLabel   = new QLabel(this);
+    prevButton  = new QPushButton(tr("Previous"),this);
+    nextButton  = new QPushButton(tr("Next"),this);
+    closeButton = new QPushButton(tr("Close"),this);
+
+    findLine->setPlaceholderText(tr("Find"));
+    findLine->setMinimumWidth(200);
+
+    // the buttons don't take the focus from the input line
+    prevButton->setFocusPolicy(Qt::NoFocus);
+    nextButton->setFocusPolicy(Qt::NoFocus);
+    closeButton->setFocusPolicy(Qt::NoFocus);
+
+    findLayout->addWidget(findLine);
+    findLayout->addWidget(hitsLabel);
+    findLayout->addWidget(prevButton);
+    findLayout->addWidget(nextButton);
+    findLayout->addWidget(closeButton);
+
+    connect(findLine,SIGNAL(textEdited(QString)),this,SLOT(textEdited(QString)));
+    connect(prevButton,SIGNAL(clicked()),this,SIGNAL(findPrevious_signal()));
+    connect(nextButton,SIGNAL(clicked()),this,SIGNAL(findNext_signal()));
+    connect(closeButton,SIGNAL(clicked()),this,SIGNAL(closed_signal()));
+
+    hide();
+
+    return;
+}
+
+/**
+ * @brief FindBar::open
+ *   Displays the bar; the searched text is selected, so typing replaces it.
+ */
+void FindBar::open()
+{
+    show();
+    raise();
+
+    findLine->setFocus();
+    findLine->selectAll();
+
+    return;
+}
+
+/**
+ * @brief FindBar::setHits
+ * @param hits  number of hits; -1 = not counted yet
+ */
+void FindBar::setHits(int hits)
+{
+    if (hits < 0 || findLine->text().isEmpty()) {
+        hitsLabel->clear();
+    } else if (hits == 0) {
+        hitsLabel->setText(tr("No hits"));
+    } else {
+        hitsLabel->setText(tr("%1 hits").arg(hits));
+    }
+
+    return;
+}
+
+/**
+ * @brief FindBar::textEdited
+ * @param text
+ */
+void FindBar::textEdited(const QString &text)
+{
+    emit find_signal(text);
+
+    return;
+}
+
+/**
+ * @brief FindBar::keyPressEvent
+ *   Return = next hit, Shift+Return = previous hit, Escape = close the bar.
+ * @param event
+ */
+void FindBar::keyPressEvent(QKeyEvent *event)
+{
+    switch (event->key()) {
+        case Qt::Key_Return:
+        case Qt::Key_Enter:
+            if (event->modifiers() & Qt::ShiftModifier) {
+                emit findPrevious_signal();
+            } else {
+                emit findNext_signal();
+            }
+            break;
+        case Qt::Key_Escape:
+            emit closed_signal();
+            break;
+        default:
+            QFrame::keyPressEvent(event);
+            break;
+    }
+
+    return;
+}
@@ -0,0 +1,64 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef FINDBAR_H
+#define FINDBAR_H
+
+#include <QBoxLayout>
+#include <QFrame>
+#include <QKeyEvent>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QString>
+
+/**
+ * @brief FindBar
+ *   Input line for the search in the scrollback of the terminal window with buttons for the
+ *   previous and the next hit and a label for the number of hits. Return searches the next hit,
+ *   Shift+Return the previous hit and Escape closes the bar.
+ */
+class FindBar : public QFrame
+{
+    Q_OBJECT
+
+    QLineEdit   *findLine;
+    QLabel      *hitsLabel;
+    QPushButton *prevButton;
+    QPushButton *nextButton;
+    QPushButton *closeButton;
+
+    void keyPressEvent(QKeyEvent *event) override;
+
+  private slots:
+    void textEdited(const QString &text);
+
+  public:
+    explicit FindBar(QWidget *parent = nullptr);
+
+    void open();                      // displays the bar and selects the searched text
+    void setHits(int hits);           // displays the number of hits; -1 = not counted
+    QString text() { return findLine->text(); }
+
+  signals:
+    void find_signal(QString);
+    void findNext_signal();
+    void findPrevious_signal();
+    void closed_signal();
+};
+
+#endif // FINDBAR_H
@@ -0,0 +1,242 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include "limitedprocess.h"
+
+using namespace std;
+
+/**
+ * @brief LimitedProcess::LimitedProcess
+ *   Constructor of the class LimitedProcess. Without limits the process is a plain QProcess.
+ * @param parent
+ */
+LimitedProcess::LimitedProcess(QObject *parent) : QProcess(parent)
+{
+    wallTimer = new QTimer(this);
+    wallTimer->setSingleShot(true);
+
+  #if QT_VERSION >= QT_VERSION_CHECK(6,0,0) && defined(Q_OS_UNIX)
+    setChildProcessModifier([this]() { applyLimits(); });
+  #endif
+
+    connect(wallTimer,SIGNAL(timeout()),this,SIGNAL(timedOut_signal()));
+    connect(this,SIGNAL(started()),this,SLOT(processStarted()));
+    connect(this,SIGNAL(finished(int,QProcess::ExitStatus)),this,SLOT(processFinished()));
+
+    return;
+}
+
+/**
+ * @brief LimitedProcess::~LimitedProcess
+ *   Destructor of the class LimitedProcess. The cgroup of the process is removed.
+ */
+LimitedProcess::~LimitedProcess()
+{
+    if (!cgroupDir.isEmpty()) QDir().rmdir(cgroupDir);
+
+    return;
+}
+
+/**
+ * @brief LimitedProcess::setLimits
+ *   Sets the limits; must be called before the process is started.
+ * @param lim
+ */
+void LimitedProcess::setLimits(const Limits &lim)
+{
+    limits = lim;
+
+    if (!limits.cgroup.isEmpty() && cgroupDir.isEmpty()) createCgroup();
+
+    return;
+}
+
+/**
+ * @brief LimitedProcess::setProcessGroup
+ *   The process is started as leader of a new process group, so a signal sent to the group
+ *   reaches the process and all its children; must be called before the process is started.
+ * @param group
+ */
+void LimitedProcess::setProcessGroup(bool group)
+{
+    processGroup = group;
+
+    return;
+}
+
+/**
+ * @brief LimitedProcess::createCgroup
+ *   Creates the cgroup of the process below the configured cgroup. The cgroup must be
+ *   delegated to the user, e.g. by systemd-run --user --scope -p Delegate=yes.
+ */
+void LimitedProcess::createCgroup()
+{
+    static int counter = 0;
+
+    QString dir = limits.cgroup+"/cmdlib-"+QString::number(QCoreApplication::applicationPid())+"-"+QString::number(++counter);
+
+    if (!QDir().mkdir(dir)) {
+      #ifdef DEBUG
+        cout << "Could not create the cgroup " << dir.toStdString() << "\n";
+      #endif
+        return;
+    }
+
+    if (limits.memory > 0) {
+        QFile memFile(dir+"/memory.max");
+        if (memFile.open(QIODevice::WriteOnly)) {
+            memFile.write(QByteArray::number((qint64)limits.memory*1048576));
+            memFile.close();
+        }
+    }
+
+    cgroupDir   = dir;
+    cgroupProcs = QFile::encodeName(dir+"/cgroup.procs");
+
+    return;
+}
+
+/**
+ * @brief LimitedProcess::applyLimits
+ *   Sets the process group and the limits in the child process after fork(). Only
+ *   async-signal-safe functions are called here; the name of the cgroup file was prepared
+ *   by the parent.
+ */
+void LimitedProcess::applyLimits()
+{
+  #ifdef Q_OS_UNIX
+    if (processGroup) setpgid(0,0);
+
+    setResourceLimits(limits);
+
+    // "0" moves the writing process into the cgroup
+    if (!cgroupProcs.isEmpty()) {
+        int fd = ::open(cgroupProcs.constData(),O_WRONLY);
+        if (fd >= 0) {
+            if (::write(fd,"0",1) < 0) {}
+            ::close(fd);
+        }
+    }
+  #endif
+
+    return;
+}
+
+/**
+ * @brief LimitedProcess::setResourceLimits
+ *   Sets the limits of CPU time, address space and open files of the calling process;
+ *   called in a child process after fork(), so only async-signal-safe functions are used.
+ *   A limit is never raised above the hard limit of the parent. The soft limit of the CPU
+ *   time sends SIGXCPU, one second later the hard limit kills the process.
+ * @param lim
+ */
+void LimitedProcess::setResourceLimits(const Limits &lim)
+{
+  #ifdef Q_OS_UNIX
+    struct rlimit rl;
+
+    if (lim.cpu > 0 && getrlimit(RLIMIT_CPU,&rl) == 0) {
+        rlim_t hard = (rlim_t)lim.cpu + 1;
+        if (rl.rlim_max != RLIM_INFINITY && rl.rlim_max < hard) hard = rl.rlim_max;
+        rl.rlim_cur = (hard > (rlim_t)lim.cpu) ? (rlim_t)lim.cpu : hard;
+        rl.rlim_max = hard;
+        setrlimit(RLIMIT_CPU,&rl);
+    }
+
+    if (lim.memory > 0 && getrlimit(RLIMIT_AS,&rl) == 0) {
+        rlim_t bytes = (rlim_t)lim.memory * 1048576;
+        if (rl.rlim_max == RLIM_INFINITY || rl.rlim_max > bytes) rl.rlim_max = bytes;
+        rl.rlim_cur = rl.rlim_max;
+        setrlimit(RLIMIT_AS,&rl);
+    }
+
+    if (lim.files > 0 && getrlimit(RLIMIT_NOFILE,&rl) == 0) {
+        if (rl.rlim_max == RLIM_INFINITY || rl.rlim_max > (rlim_t)lim.files) rl.rlim_max = lim.files;
+        rl.rlim_cur = rl.rlim_max;
+        setrlimit(RLIMIT_NOFILE,&rl);
+    }
+  #else
+    Q_UNUSED(lim);
+  #endif
+
+    return;
+}
+
+#if QT_VERSION < QT_VERSION_CHECK(6,0,0)
+/**
+ * @brief LimitedProcess::setupChildProcess
+ *   Is called by Qt 5 in the child process before exec().
+ */
+void LimitedProcess::setupChildProcess()
+{
+    applyLimits();
+
+    return;
+}
+#endif
+
+/**
+ * @brief LimitedProcess::processStarted
+ *   Starts watching the wall clock time.
+ */
+void LimitedProcess::processStarted()
+{
+    if (limits.timeout > 0) wallTimer->start(limits.timeout*1000);
+
+    return;
+}
+
+/**
+ * @brief LimitedProcess::processFinished
+ */
+void LimitedProcess::processFinished()
+{
+    wallTimer->stop();
+
+    if (!cgroupDir.isEmpty() && QDir().rmdir(cgroupDir)) cgroupDir.clear();
+
+    return;
+}
+
+/**
+ * @brief LimitedProcess::parseLimit
+ *   Reads a limit from a line of the notes of a command, e.g. "@timeout=60". The keys are
+ *   timeout (seconds), cpu (seconds), mem (MB) and files; 0 = unlimited.
+ * @param line
+ * @param lim  the limit of the key is replaced
+ * @return true if the line is a limit
+ */
+bool LimitedProcess::parseLimit(const QString &line, Limits &lim)
+{
+    QString text = line.trimmed();
+
+    if (!text.startsWith('@') || !text.contains('=')) return false;
+
+    QString key   = text.mid(1,text.indexOf('=')-1).trimmed().toLower();
+    bool    ok    = false;
+    int     value = text.mid(text.indexOf('=')+1).trimmed().toInt(&ok);
+
+    if (!ok || value < 0) return false;
+
+    if (key == "timeout")    lim.timeout = value;
+    else if (key == "cpu")   lim.cpu     = value;
+    else if (key == "mem")   lim.memory  = value;
+    else if (key == "files") lim.files   = value;
+    else return false;
+
+    return true;
+}
@@ -0,0 +1,92 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef LIMITEDPROCESS_H
+#define LIMITEDPROCESS_H
+
+#include <iostream>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QProcess>
+#include <QString>
+#include <QTimer>
+#include "main.h"
+
+#ifdef Q_OS_UNIX
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/resource.h>
+#endif
+
+/**
+ * @brief LimitedProcess
+ *   Process with limits of its resources. The limits of CPU time, address space and open
+ *   files are set with setrlimit() in the child process between fork() and exec(), so they
+ *   apply to the command and are inherited by its children. Optionally the process is moved
+ *   to its own cgroup, whose memory limit applies to all its descendants together. The wall
+ *   clock time is watched by a timer; timedOut_signal() is emitted if it expires.
+ */
+class LimitedProcess : public QProcess
+{
+    Q_OBJECT
+
+  public:
+    // structure of the limits; 0 = unlimited
+    struct Limits {
+        int     timeout = 0;  // wall clock time in seconds
+        int     cpu     = 0;  // CPU time in seconds
+        int     memory  = 0;  // address space in MB
+        int     files   = 0;  // open files
+        QString cgroup;       // delegated cgroup v2 directory the jobs' cgroups are created in; empty = none
+    };
+
+  private:
+    Limits limits;
+
+    bool processGroup = false;  // the process leads a new process group
+
+    QTimer    *wallTimer;
+    QString    cgroupDir;    // cgroup of the process; empty = none
+    QByteArray cgroupProcs;  // cgroup.procs of the cgroup; prepared for the child process
+
+    void applyLimits();
+    void createCgroup();
+
+  #if QT_VERSION < QT_VERSION_CHECK(6,0,0)
+  protected:
+    void setupChildProcess() override;
+  #endif
+
+  private slots:
+    void processStarted();
+    void processFinished();
+
+  public:
+    explicit LimitedProcess(QObject *parent = nullptr);
+    ~LimitedProcess();
+
+    void setLimits(const Limits &lim);
+    void setProcessGroup(bool group);  // the process and its children get their own process group
+    static bool parseLimit(const QString &line, Limits &lim);  // reads a line "@key=value" of the notes of a command
+    static void setResourceLimits(const Limits &lim);  // sets the rlimits of the calling process; async-signal-safe
+
+  signals:
+    void timedOut_signal();
+};
+
+#endif // LIMITEDPROCESS_H
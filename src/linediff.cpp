@@ -0,0 +1,142 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include "linediff.h"
+
+/**
+ * @brief LineDiff::add
+ *   Appends lines to the edit script; runs of the same operation are joined.
+ * @param edits
+ * @param op
+ * @param count
+ */
+void LineDiff::add(vector<Edit> &edits, Op op, int count)
+{
+    if (count <= 0) return;
+
+    if (!edits.empty() && edits.back().op == op) {
+        edits.back().count+= count;
+    } else {
+        edits.push_back({op,count});
+    }
+
+    return;
+}
+
+/**
+ * @brief LineDiff::compute
+ *   Computes the edit script converting the old lines into the new lines.
+ * @param oldLines  hashes of the old lines
+ * @param newLines  hashes of the new lines
+ * @param maxEdits  maximum edit distance searched
+ * @return runs of equal, deleted and inserted lines in the order of the lines
+ */
+vector<LineDiff::Edit> LineDiff::compute(const vector<uint64_t> &oldLines, const vector<uint64_t> &newLines, int maxEdits)
+{
+    vector<Edit> edits;
+
+    int head = 0;
+    int tail = 0;
+    int sizeA = (int)oldLines.size();
+    int sizeB = (int)newLines.size();
+
+    // common head and tail
+    while (head < sizeA && head < sizeB && oldLines[head] == newLines[head]) head++;
+    while (tail < sizeA-head && tail < sizeB-head && oldLines[sizeA-1-tail] == newLines[sizeB-1-tail]) tail++;
+
+    const uint64_t *a = oldLines.data() + head;
+    const uint64_t *b = newLines.data() + head;
+
+    int n = sizeA - head - tail;
+    int m = sizeB - head - tail;
+    int offset = n + m + 1;
+
+    vector<int> v(2*offset+1,0);    // furthest x of every diagonal k at index k+offset
+    vector<vector<int>> trace;      // v of the diagonals -d..d after every round d
+    int dist = -1;
+
+    for (int d = 0; d <= n+m && d <= maxEdits && dist < 0; d++) {
+        for (int k = -d; k <= d; k+= 2) {
+            int x;
+            if (k == -d || (k != d && v[k-1+offset] < v[k+1+offset])) {
+                x = v[k+1+offset];      // down: a line of b is inserted
+            } else {
+                x = v[k-1+offset] + 1;  // right: a line of a is deleted
+            }
+            int y = x - k;
+            while (x < n && y < m && a[x] == b[y]) {
+                x++;
+                y++;
+            }
+            v[k+offset] = x;
+            if (x >= n && y >= m) dist = d;
+        }
+        trace.push_back(vector<int>(v.begin()+offset-d,v.begin()+offset+d+1));
+    }
+
+    add(edits,EQUAL,head);
+
+    // too many differences? => all lines between head and tail are replaced
+    if (dist < 0) {
+        add(edits,DELETE,n);
+        add(edits,INSERT,m);
+        add(edits,EQUAL,tail);
+        return edits;
+    }
+
+    // backtrack from the end to the start; the moves are collected in reverse order
+    vector<Edit> reverse;
+    int x = n;
+    int y = m;
+
+    for (int d = dist; d > 0; d--) {
+        const vector<int> &prev = trace[d-1];  // index k+(d-1)
+        int k = x - y;
+        int prevK;
+        if (k == -d || (k != d && prev[k-1+d-1] < prev[k+1+d-1])) {
+            prevK = k + 1;
+        } else {
+            prevK = k - 1;
+        }
+        int prevX = prev[prevK+d-1];
+        int prevY = prevX - prevK;
+        int snake = 0;
+        while (x > prevX && y > prevY) {
+            x--;
+            y--;
+            snake++;
+        }
+        add(reverse,EQUAL,snake);
+        if (x == prevX) {
+            add(reverse,INSERT,1);
+        } else {
+            add(reverse,DELETE,1);
+        }
+        x = prevX;
+        y = prevY;
+    }
+
+    add(reverse,EQUAL,x);
+
+    for (int idx = (int)reverse.size()-1; idx >= 0; idx--) {
+        add(edits,reverse[idx].op,reverse[idx].count);
+    }
+
+    add(edits,EQUAL,tail);
+
+    return edits;
+}
@@ -0,0 +1,51 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef LINEDIFF_H
+#define LINEDIFF_H
+
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief LineDiff
+ *   Shortest edit script between two sequences of lines after Myers' O(ND) algorithm. The
+ *   lines are compared by their hashes, so a comparison costs one integer comparison. The
+ *   common head and tail are removed before; the V arrays of every edit distance d are kept
+ *   only for the diagonals -d..d, so the memory is O(D²). More than maxEdits differences are
+ *   reported as replacing all lines between head and tail.
+ */
+class LineDiff
+{
+  public:
+    enum Op { EQUAL, DELETE, INSERT };
+
+    // structure of a run of lines with the same operation
+    struct Edit {
+        Op  op;
+        int count;
+    };
+
+    static vector<Edit> compute(const vector<uint64_t> &oldLines, const vector<uint64_t> &newLines, int maxEdits = 2000);
+
+  private:
+    static void add(vector<Edit> &edits, Op op, int count);
+};
+
+#endif // LINEDIFF_H
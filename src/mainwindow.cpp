@@ -38,14 +38,15 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), internVar(10)
     cfgAccess.setConfig(cfgFile);
     cfgAccess.readConfig();
 
-    bool convOk;
+  // setup the history file of the terminal window; the history is read on the first access
+    cmdHistory.setFile("cmdlib.hst",cfgAccess.getInt("HISTSIZE",100000));
 
   // get the position, width and height of the window from the configuration
-    winPosX    = QString(cfgAccess.getValue("WINPOSX").c_str()).toInt(&convOk,10);
-    winPosY    = QString(cfgAccess.getValue("WINPOSY").c_str()).toInt(&convOk,10);
-    winWidth   = QString(cfgAccess.getValue("WINWIDTH").c_str()).toInt(&convOk,10);
-    winHeight  = QString(cfgAccess.getValue("WINHEIGHT").c_str()).toInt(&convOk,10);
-    notesWidth = QString(cfgAccess.getValue("NOTESWIDTH").c_str()).toInt(&convOk,10);
+    winPosX    = cfgAccess.getInt("WINPOSX");
+    winPosY    = cfgAccess.getInt("WINPOSY");
+    winWidth   = cfgAccess.getInt("WINWIDTH");
+    winHeight  = cfgAccess.getInt("WINHEIGHT");
+    notesWidth = cfgAccess.getInt("NOTESWIDTH");
 
     // default size if there is no configuration
     if ((winWidth == 0) || (winHeight == 0)) {
@@ -136,6 +137,11 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), internVar(10)
 
     connect(buttonDel,SIGNAL(clicked()),this,SLOT(buttonDeletePressed()));
 
+    buttonRun = new QPushButton(this);
+    gridDBAccessButtons->addWidget(buttonRun,4,0);
+
+    connect(buttonRun,SIGNAL(clicked()),this,SLOT(buttonRunPressed()));
+
     widgetDBAccessButtons->setMinimumWidth(DBACCESSBUTTONSWIDTH);
     widgetDBAccessButtons->setMaximumWidth(DBACCESSBUTTONSWIDTH);
     widgetDBAccessButtons->setLayout(gridDBAccessButtons);
@@ -202,18 +208,63 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), internVar(10)
     toolBar->setAllowedAreas(Qt::TopToolBarArea);
     toolBar->setMovable(false);
 
+  // the combo boxes display models reading the categories and commands from dbAccess;
+  // the popup lists have rows of equal height, so only the visible rows are laid out
+    catModel = new CategoryModel(&dbAccess,this);
+    cmdModel = new CommandModel(&dbAccess,this);
+
+    QListView *catView = new QListView;
+    catView->setUniformItemSizes(true);
+
     combCategories = new QComboBox;
     combCategories->setSizeAdjustPolicy(QComboBox::AdjustToContents);
+    combCategories->setView(catView);
+    combCategories->setModel(catModel);
     toolBar->addWidget(combCategories);
 
+    QListView *cmdView = new QListView;
+    cmdView->setUniformItemSizes(true);
+
+    // the width isn't adjusted to the longest command, which would measure all commands of the category
     combCommands = new QComboBox;
-    combCommands->setSizeAdjustPolicy(QComboBox::AdjustToContents);
+    combCommands->setSizeAdjustPolicy(QComboBox::AdjustToMinimumContentsLengthWithIcon);
+    combCommands->setMinimumContentsLength(COMMANDLISTCHARS);
+    combCommands->setView(cmdView);
+    combCommands->setModel(cmdModel);
     toolBar->addWidget(combCommands);
 
+    // the filter searches the commands of all categories in the thread of cmdFilter,
+    // when the typing pauses; the matching commands are displayed by the completer popup
+    lineEditFilter = new QLineEdit;
+    lineEditFilter->setClearButtonEnabled(true);
+    lineEditFilter->setMaximumWidth(lineEditFilter->fontMetrics().averageCharWidth()*FILTERCHARS*2);
+    toolBar->addWidget(lineEditFilter);
+
+    filterModel = new QStringListModel(this);
+
+    filterCompleter = new QCompleter(filterModel,this);
+    filterCompleter->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+    filterCompleter->setMaxVisibleItems(FILTERVISIBLE);
+    filterCompleter->setWidget(lineEditFilter);  // not setCompleter(), the line edit keeps its text
+
+    filterTimer = new QTimer(this);
+    filterTimer->setSingleShot(true);
+    filterTimer->setInterval(FILTERDELAY);
+
+    cmdFilter = new CommandFilter(&dbAccess.cmdIndex(),this);
+
+    connect(lineEditFilter,SIGNAL(textEdited(QString)),this,SLOT(filterEdited(QString)));
+    connect(filterTimer,SIGNAL(timeout()),this,SLOT(filterStart()));
+    connect(cmdFilter,SIGNAL(results_signal(QString,QStringList,QStringList)),this,SLOT(filterResults(QString,QStringList,QStringList)));
+    connect(filterCompleter,SIGNAL(activated(QModelIndex)),this,SLOT(filterActivated(QModelIndex)));
+
     currCatNum = 0;
-    setCategories();
+    currCmdNum = -1;
     setCommands(currCatNum);
 
+    // the combo boxes and the notes follow the changes of the database
+    dbAccess.addListener(this);
+
     connect(combCategories,SIGNAL(activated(int)),this,SLOT(setCommands(int)));
     connect(combCommands,SIGNAL(activated(int)),this,SLOT(setCommandSelected(int)));
     connect(this,SIGNAL(commandSelectedSignal(QString *)),textEditTerminal,SLOT(setCommandSelected(QString *)));
@@ -221,14 +272,19 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), internVar(10)
   // add a status line to the application
     statusBar = new QStatusBar;
 
-    labelStatusBarLeft  = new QLabel;
-    labelStatusBarRight = new QLabel;
+    labelStatusBarLeft    = new QLabel;
+    labelStatusBarRight   = new QLabel;
+    labelStatusBarProfile = new QLabel;
 
     labelStatusBarLeft->setMinimumWidth(DBACCESSBUTTONSWIDTH+5);
     labelStatusBarLeft->setMaximumWidth(DBACCESSBUTTONSWIDTH+5);
 
     statusBar->addWidget(labelStatusBarLeft);
     statusBar->addWidget(labelStatusBarRight);
+    statusBar->addPermanentWidget(labelStatusBarProfile);
+
+    // the durations of the choosen command are updated after every executed command
+    connect(textEditTerminal,SIGNAL(commandProfiled_signal()),this,SLOT(displayProfile()));
 
     setStatusBar(statusBar);
 
@@ -257,6 +313,12 @@ MainWindow::~MainWindow(void)
         delete statusBar;
     }
 
+    // the filter thread and the models use dbAccess; they are removed before dbAccess is destroyed
+    delete cmdFilter;
+    dbAccess.removeListener(this);
+    delete cmdModel;
+    delete catModel;
+
     return;
 }
 
@@ -284,6 +346,10 @@ void MainWindow::translateMainWindow()
     buttonAdd->setText(tr("&Add"));
     buttonMod->setText(tr("&Modify"));
     buttonDel->setText(tr("De&lete"));
+    buttonRun->setText(tr("&Run Category"));
+
+  // text for the filter
+    lineEditFilter->setPlaceholderText(tr("Filter commands"));
 
   // text for the note area
     dockWidgetRight->setWindowTitle(tr("Notes"));
@@ -359,9 +425,6 @@ void MainWindow::resetDB()
     dbState = DB_NEW;
     dbName  = "New";
 
-    currCatNum = 0;
-    setCategories();
-    setCommands(currCatNum);
     setDBName(false);
 
     QString lc;
@@ -454,14 +517,14 @@ void MainWindow::closeEvent(QCloseEvent *event)/*exit()*/
   // add the window position and size to the configuration and then save the configuration
   //QSize winSize = this->size();
     QRect winGeometry = this->geometry();
-    cfgAccess.setValue("WINPOSX",QString::number(winGeometry.x(),10).toStdString());
-    cfgAccess.setValue("WINPOSY",QString::number(winGeometry.y(),10).toStdString());
-    cfgAccess.setValue("WINWIDTH",QString::number(winGeometry.width(),10).toStdString());
-    cfgAccess.setValue("WINHEIGHT",QString::number(winGeometry.height(),10).toStdString());
+    cfgAccess.setInt("WINPOSX",winGeometry.x());
+    cfgAccess.setInt("WINPOSY",winGeometry.y());
+    cfgAccess.setInt("WINWIDTH",winGeometry.width());
+    cfgAccess.setInt("WINHEIGHT",winGeometry.height());
     notesWidth = dockWidgetRight->width();
-    cfgAccess.setValue("NOTESWIDTH",QString::number(notesWidth,10).toStdString());
+    cfgAccess.setInt("NOTESWIDTH",notesWidth);
     cfgAccess.setValue("LANG",language);
-    cfgAccess.writeConfig();
+    cfgAccess.writeConfig();  // written only if the configuration is modified
 
     event->accept();  // close the application
   //event->ignore();  // the application is not closed
@@ -492,9 +555,40 @@ QLabel *MainWindow::createTerminalLabel()
  *   Creates the terminal window.
  * @return terminal window
  */
-QTextEdit *MainWindow::createTerminalWindow()
+TerminalWindow *MainWindow::createTerminalWindow()
 {
-    QTextEdit *tw = new TerminalWindow();
+    TerminalWindow *tw = new TerminalWindow();
+
+    // limit the scrollback of the terminal window
+    tw->setScrollback(cfgAccess.getInt("SCROLLBACKLINES",10000),
+                      cfgAccess.getInt("SCROLLBACKCHARS",0));
+
+    tw->setHistory(&cmdHistory);
+
+    // backend of the external commands: "bash" = persistent shell; "pty" = pseudo terminal;
+    // otherwise a process per command
+    tw->setBackend(QString(cfgAccess.getValue("BACKEND").c_str()));
+    tw->setProfile(&cmdProfile,cfgAccess.getBool("PROFILE",true));
+
+    // default limits of the external commands; 0 = unlimited
+    cmdLimits.timeout = cfgAccess.getInt("LIMITTIMEOUT",0);
+    cmdLimits.cpu     = cfgAccess.getInt("LIMITCPU",0);
+    cmdLimits.memory  = cfgAccess.getInt("LIMITMEM",0);
+    cmdLimits.files   = cfgAccess.getInt("LIMITFILES",0);
+    cmdLimits.cgroup  = QString(cfgAccess.getValue("LIMITCGROUP").c_str());
+
+    tw->setLimits(cmdLimits);
+
+    // outputs of the cacheable commands; CACHESIZE in MB
+    cmdCache.setDirectory("cmdlib.cache",(qint64)cfgAccess.getInt("CACHESIZE",50)*1048576);
+
+    tw->setCache(&cmdCache);
+
+    // log of the commands and their output; no log file configured = no log
+    tw->setSessionLog(QString(cfgAccess.getValue("LOGFILE").c_str()),
+                      cfgAccess.getInt("LOGSIZE",10),
+                      cfgAccess.getInt("LOGSEGMENTS",5));
+
     return tw;
 }
 
@@ -560,7 +654,7 @@ void MainWindow::buttonAddPressed()
         return;
     }
 
-    AddDialog *addDialog = new AddDialog(new QString(lineEditLastCommand->text()/*lastCmd.c_str()*/),catList,this);
+    AddDialog *addDialog = new AddDialog(new QString(lineEditLastCommand->text()/*lastCmd.c_str()*/),dbAccess.catRead(),this);
 
     if (addDialog->exec()) {
 
@@ -569,29 +663,15 @@ void MainWindow::buttonAddPressed()
 
         int cmdExistsCntr = 0;
 
-        iterStr iter = catList.begin();
-
         // find the choosen category in the category list
-        for (currCatNum = 0; currCatNum < (int)catList.size(); currCatNum++) {
-            if (iter->c_str() == category.toStdString()) break;
-            iter++;
-        }
+        int catNum = dbAccess.catFind(category.toStdString());
 
-        // New category entered?
-        if (iter == catList.end()) {
-            catList.push_back(category.toStdString());
-            combCategories->addItem(catList.back().c_str());  // catList.back() returns a reference on the string
-        } else {
+        // Category exists?
+        if (catNum >= 0) {
             cmdExistsCntr++;
 
-            list<string> cmdListCat = dbAccess.cmdRead(category.toStdString());
-
-            // find the added command in the command list;
-            // std:: due to qwidget contains a static find method
-            iter = std::find(cmdListCat.begin(),cmdListCat.end(),command.toStdString());
-
-            // New command entered?
-            if (iter != cmdListCat.end()) {
+            // Command exists in the category?
+            if (dbAccess.cmdFind(catNum,command.toStdString()) >= 0) {
                 cmdExistsCntr++;
             }
         }
@@ -612,9 +692,16 @@ void MainWindow::buttonAddPressed()
                 cmd.push_back(notes.takeAt(0).toStdString()/*+'\n'*/);
             }
 
+            // the models of the combo boxes insert the new rows
             dbAccess.cmdAdd(cmd);
-            setCommands(currCatNum);  // Show command in the command list.
-            combCommands->setCurrentIndex(cmdList.size()-1);
+
+            catNum = dbAccess.catFind(category.toStdString());
+
+            if (catNum != currCatNum) {
+                setCommands(catNum);  // Show command in the command list.
+            }
+
+            combCommands->setCurrentIndex(dbAccess.cmdCount(catNum)-1);
             setDBName(true);
 
             switch (dbState) {
@@ -692,7 +779,6 @@ void MainWindow::buttonModifyPressed()
                 msgBox->setIcon(QMessageBox::Information);
                 msgBox->setText(tr("Command successful modified."));
 
-                setCommands(currCatNum);
                 combCommands->setCurrentIndex(currCmdNum);
                 setDBName(true);
 
@@ -761,14 +847,6 @@ void MainWindow::buttonDeletePressed()
                 msgBox->setIcon(QMessageBox::Information);
                 msgBox->setText(tr("Command successful deleted."));
 
-                // Last command from the category deleted?
-                if (cmdList.size()-1 == 0) {
-                    if (currCatNum > 0) currCatNum--;
-                    setCategories();
-                }
-
-                currCmd.clear();
-                setCommands(currCatNum);
                 setDBName(true);
 
                 switch (dbState) {
@@ -797,23 +875,63 @@ void MainWindow::buttonDeletePressed()
  ****************************************************************************/
 
 /**
- * @brief MainWindow::setCategories
- *   Creates a list with the available categories and adds the categories
- *   to the categories combo box.
+ * @brief MainWindow::recordChanged
+ *   Is called by dbAccess after a command was modified. The selected command follows
+ *   the modification.
+ * @param cat
+ * @param num
  */
-void MainWindow::setCategories(void)
+void MainWindow::recordChanged(int cat, int num)
 {
-    catList = dbAccess.catRead();
+    if (cat == currCatNum && num == currCmdNum) {
+        currCmd = dbAccess.cmdAt(cat,num);
+    }
 
-    combCategories->clear();
+    return;
+}
 
-    for (iterStr iter = catList.begin(); iter!= catList.end(); iter++) {
-        combCategories->addItem(iter->c_str());
+/**
+ * @brief MainWindow::recordRemoved
+ *   Is called by dbAccess after a command was deleted. The notes of the deleted command
+ *   are removed; without commands left the previous category is displayed.
+ * @param cat
+ * @param num
+ * @param lastCmd
+ */
+void MainWindow::recordRemoved(int cat, int num, bool lastCmd)
+{
+    if (cat == currCatNum) {
+        if (num == currCmdNum) {
+            currCmd.clear();
+            currCmdNum = -1;
+            textEditCommandNotes->clear();
+        } else if (num < currCmdNum) {
+            currCmdNum--;
+        }
+        if (lastCmd) {
+            if (currCatNum > 0) currCatNum--;
+            setCommands(currCatNum);
+        }
+    } else if (lastCmd && cat < currCatNum) {
+        currCatNum--;
     }
 
     return;
 }
 
+/**
+ * @brief MainWindow::recordsReset
+ *   Is called by dbAccess after the database was read or cleared. The first category
+ *   is displayed.
+ */
+void MainWindow::recordsReset()
+{
+    currCatNum = 0;
+    setCommands(currCatNum);
+
+    return;
+}
+
 /**
  * @brief MainWindow::setCommands
  *   Creates a list with the available commands of a choosen category and
@@ -823,48 +941,155 @@ void MainWindow::setCategories(void)
 void MainWindow::setCommands(int cat)
 {
     // Are there any categories?
-    if (!catList.empty()) {
-
-        iterStr iter = catList.begin();
-
-        for (int cntr = 0; cntr < cat; cntr++) {
-            iter++;
-        }
-
-        currCat = iter->c_str();
-        cmdList = dbAccess.cmdRead(currCat);  // read the commands of the category
+    if (dbAccess.catCount() > 0) {
+        currCat = dbAccess.catAt(cat);
+        cmdModel->setCategory(cat);  // the model reads the commands of the category on demand
 
         combCategories->setCurrentIndex(cat);
     } else {
         currCat.clear();
         currCmd.clear();
-        cmdList.clear();
+        cmdModel->setCategory(-1);
+    }
+
+    combCommands->setCurrentIndex(cmdModel->rowCount() > 0 ? 0 : -1);
+
+    currCatNum = cat;  // is set too here, because the method is a slot of the category choice
+
+    return;
+}
+
+/**
+ * @brief MainWindow::filterEdited
+ *   Is called on every keystroke in the filter. The search starts when the typing pauses.
+ * @param text
+ */
+void MainWindow::filterEdited(const QString &text)
+{
+    Q_UNUSED(text);
+
+    filterTimer->start();
+
+    return;
+}
+
+/**
+ * @brief MainWindow::filterStart
+ *   Queues the filter text for the search in the thread of cmdFilter.
+ */
+void MainWindow::filterStart()
+{
+    QString text = lineEditFilter->text().trimmed();
+
+    if (text.isEmpty()) {
+        filterCompleter->popup()->hide();
+        return;
     }
 
-    combCommands->clear();
+    cmdFilter->filter(text);
+
+    return;
+}
+
+/**
+ * @brief MainWindow::filterResults
+ *   Displays the commands found by cmdFilter. Results of a text changed meanwhile are ignored.
+ * @param text
+ * @param categories
+ * @param commands
+ */
+void MainWindow::filterResults(QString text, QStringList categories, QStringList commands)
+{
+    QStringList rows;
+
+    if (text != lineEditFilter->text().trimmed()) return;
+
+    filterCats = categories;
+    filterCmds = commands;
 
-    for (iterStr iter = cmdList.begin(); iter!= cmdList.end(); iter++) {
-        combCommands->addItem(iter->c_str());
+    for (int idx = 0; idx < commands.size(); idx++) {
+        rows << commands.at(idx) + "   (" + categories.at(idx) + ")";
     }
 
-    currCatNum = cat;  // is set too here, because the method is a slot of the category choice
+    filterModel->setStringList(rows);
+
+    if (rows.isEmpty()) {
+        filterCompleter->popup()->hide();
+    } else {
+        filterCompleter->complete();
+    }
 
     return;
 }
 
 /**
- * @brief MainWindow::setCommandSelected
- * @param cmd
+ * @brief MainWindow::filterActivated
+ *   Selects the category and the command chosen in the filter results.
+ * @param index
  */
-void MainWindow::setCommandSelected(int cmd)
+void MainWindow::filterActivated(const QModelIndex &index)
 {
-    iterStr iter = cmdList.begin();
+    int row = index.row();
 
-    for (int cntr = 0; cntr < cmd; cntr++) {
-        iter++;
+    if (row < 0 || row >= filterCmds.size()) return;
+
+    int catNum = dbAccess.catFind(filterCats.at(row).toStdString());
+    int cmdNum = catNum < 0 ? -1 : dbAccess.cmdFind(catNum,filterCmds.at(row).toStdString());
+
+    // Command deleted meanwhile?
+    if (cmdNum < 0) return;
+
+    setCommands(catNum);
+    combCommands->setCurrentIndex(cmdNum);
+    setCommandSelected(cmdNum);
+
+    lineEditFilter->clear();
+    filterModel->setStringList(QStringList());
+
+    return;
+}
+
+/**
+ * @brief MainWindow::buttonRunPressed
+ *   Executes all commands of the selected category as a batch. BATCHPARALLEL commands run at
+ *   the same time; the notes of a command may contain its dependencies and limits.
+ */
+void MainWindow::buttonRunPressed()
+{
+    if (currCat.empty()) {
+        QMessageBox::information(this,tr("Run Category"),tr("No category selected!"));
+        return;
     }
 
-    currCmd = iter->c_str();
+    BatchRunner *runner = new BatchRunner();
+
+    list<string> cmds = dbAccess.cmdRead(currCat);
+
+    for (iterStr iter = cmds.begin(); iter != cmds.end(); iter++) {
+        list<string> notes = dbAccess.ntsRead(currCat,*iter);
+        QStringList  lines;
+        for (iterStr note = notes.begin(); note != notes.end(); note++) {
+            lines << QString(note->c_str());
+        }
+        runner->addTask(QString(iter->c_str()),lines,cmdLimits);
+    }
+
+    BatchDialog *dialog = new BatchDialog(QString(currCat.c_str()),runner,this);
+
+    dialog->show();
+
+    runner->start(textEditTerminal->workingDirectory(),cfgAccess.getInt("BATCHPARALLEL",QThread::idealThreadCount()));
+
+    return;
+}
+
+/**
+ * @brief MainWindow::setCommandSelected
+ * @param cmd
+ */
+void MainWindow::setCommandSelected(int cmd)
+{
+    currCmd = dbAccess.cmdAt(currCatNum,cmd);
     QString str(currCmd.c_str());
 
     emit commandSelectedSignal(&str/*new QString(currCmd.c_str())*/);
@@ -873,15 +1098,47 @@ void MainWindow::setCommandSelected(int cmd)
 
     textEditCommandNotes->clear();
 
+    // lines "@timeout=60", "@cpu=10", "@mem=512" or "@files=64" of the notes override the default limits;
+    // "@cache=60" replays the output of the command for 60 s
+    LimitedProcess::Limits entryLimits = cmdLimits;
+    int cacheTtl = 0;
+
     while (!notes.empty()) {
         str = notes.front().c_str();
         notes.pop_front();
         textEditCommandNotes->append(str);
+        if (!LimitedProcess::parseLimit(str,entryLimits)) ResultCache::parseTtl(str,cacheTtl);
     }
 
+    textEditTerminal->setEntry(QString(currCmd.c_str()),entryLimits,cacheTtl);
+
     textEditTerminal->setFocus();
     currCmdNum = cmd;
 
+    displayProfile();
+
+    return;
+}
+
+/**
+ * @brief MainWindow::displayProfile
+ *   Displays the number of executions and the median and 95th percentile of the
+ *   durations of the choosen command in the status bar.
+ */
+void MainWindow::displayProfile()
+{
+    long   count;
+    double p50;
+    double p95;
+
+    // the entered commands are kept without leading and trailing spaces
+    if (currCmd.empty() || !cmdProfile.get(QString(currCmd.c_str()).trimmed().toStdString(),count,p50,p95)) {
+        labelStatusBarProfile->clear();
+        return;
+    }
+
+    labelStatusBarProfile->setText(tr("Runs")+": "+QString::number(count)+"  p50: "+QString::number(p50,'f',3)+"s  p95: "+QString::number(p95,'f',3)+"s");
+
     return;
 }
 
@@ -895,6 +1152,8 @@ void MainWindow::setCommandEntered(QString *cmd)
     if (*cmd != "exit") {
       //lastCmd = cmd->toStdString();
         lineEditLastCommand->setText(*cmd);
+        // the entered commands are kept in the history
+        if (!cmd->isEmpty()) cmdHistory.append(cmd->toStdString());
     } else {
         close();
     }
@@ -911,10 +1170,9 @@ void MainWindow::setCommandEntered(QString *cmd)
  */
 void MainWindow::displayHintSQLite()
 {
-    string dontShow;
     QMessageBox msgBox;
 
-    if (cfgAccess.getValue("HINTSQLITE") != "false") {
+    if (cfgAccess.getBool("HINTSQLITE",true)) {
 
         msgBox.setWindowTitle("Command Library");
         msgBox.setIcon(QMessageBox::Information);
@@ -927,13 +1185,7 @@ void MainWindow::displayHintSQLite()
         msgBox.setDefaultButton(btnOk);
         msgBox.exec();
 
-        if (msgBox.clickedButton() == btnDontShow) {
-            dontShow = "false";
-        } else {
-            dontShow = "true";
-        }
-
-        cfgAccess.setValue("HINTSQLITE",dontShow);
+        cfgAccess.setBool("HINTSQLITE",msgBox.clickedButton() != btnDontShow);
     }
 
     return;
@@ -1117,9 +1369,6 @@ void MainWindow::dbMenuOpen()
 
         dbState = DB_LOADED;
 
-        currCatNum = 0;
-        setCategories();
-        setCommands(currCatNum);
         getDBName();
         setDBName(false);
 
@@ -22,13 +22,16 @@
 #include <iostream>
 #include <list>
 #include <string>
+#include <QAbstractItemView>
 #include <QComboBox>
+#include <QCompleter>
 #include <QDialog>
 #include <QDockWidget>
 #include <QFileDialog>
 #include <QGridLayout>
 #include <QLabel>
 #include <QLineEdit>
+#include <QListView>
 #include <QMainWindow>
 #include <QMenuBar>
 #include <QMessageBox>
@@ -36,14 +39,25 @@
 #include <QPushButton>
 #include <QScrollArea>
 #include <QStatusBar>
+#include <QStringListModel>
 #include <QTextEdit>
+#include <QThread>
+#include <QTimer>
 #include <QToolBar>
 #include <QWidget>
 #include "adddialog.h"
+#include "batchdialog.h"
+#include "categorymodel.h"
 #include "cfgaccess.h"
+#include "cmdhistory.h"
+#include "cmdprofile.h"
+#include "commandfilter.h"
+#include "commandmodel.h"
 #include "dbaccess.h"
 #include "introwindow.h"
+#include "limitedprocess.h"
 #include "main.h"
+#include "resultcache.h"
 #include "settingsdialog.h"
 #include "terminalwindow.h"
 
@@ -58,11 +72,15 @@ QT_END_NAMESPACE*/
 /**
  * @brief MainWindow
  */
-class MainWindow : public QMainWindow
+class MainWindow : public QMainWindow, public DBAccess::Listener
 {
     Q_OBJECT
 
     #define DBACCESSBUTTONSWIDTH  120
+    #define COMMANDLISTCHARS      40   // width of the command list in characters
+    #define FILTERCHARS           20   // width of the filter in characters
+    #define FILTERDELAY           120  // time in ms after the last keystroke the filter is searched
+    #define FILTERVISIBLE         15   // number of visible rows of the filter results
 
     /**
      * @brief CommandNotesWindow
@@ -89,13 +107,15 @@ class MainWindow : public QMainWindow
     QLabel      *labelTerminal;
     QLabel      *labelStatusBarLeft;
     QLabel      *labelStatusBarRight;
-    QTextEdit   *textEditTerminal;
+    QLabel      *labelStatusBarProfile;
+    TerminalWindow *textEditTerminal;
     QTextEdit   *textEditCommandNotes;
     QLineEdit   *lineEditLastCommand;
     QPushButton *buttonClr;
     QPushButton *buttonAdd;
     QPushButton *buttonMod;
     QPushButton *buttonDel;
+    QPushButton *buttonRun;
     QMenuBar    *menuBarMain;
     QMenu       *menuDB;
     QAction     *menuDBEntry1;
@@ -115,11 +135,25 @@ class MainWindow : public QMainWindow
     QStatusBar  *statusBar;
     QComboBox   *combCategories;
     QComboBox   *combCommands;
+    CategoryModel *catModel;  // categories of the database displayed by combCategories
+    CommandModel  *cmdModel;  // commands of the choosen category displayed by combCommands
+    QLineEdit   *lineEditFilter;
+    QStringListModel *filterModel;      // commands matching the filter text
+    QCompleter    *filterCompleter;     // popup of lineEditFilter displaying filterModel
+    QTimer        *filterTimer;         // delays the search until the typing pauses
+    CommandFilter *cmdFilter;           // searches the commands of all categories
+    QStringList filterCats;             // categories of the commands in filterModel
+    QStringList filterCmds;             // commands in filterModel
 
     QString recentDB;
 
-    CfgAccess cfgAccess;
-    DBAccess  dbAccess;
+    CfgAccess  cfgAccess;
+    CmdHistory cmdHistory;
+    CmdProfile cmdProfile;
+
+    LimitedProcess::Limits cmdLimits;  // default limits of the external commands
+    ResultCache cmdCache;              // outputs of the cacheable commands
+    DBAccess   dbAccess;
 
     IntroWindow *introductionWindow;
 
@@ -137,9 +171,6 @@ class MainWindow : public QMainWindow
     string cfgFile;   // name of the configuration file
     string language;  // language used by the application
 
-    list<string> catList;  // contains all available categories
-    list<string> cmdList;  // contains the commands of the choosen category
-
     list<string> recentDBs;  // contains the recent used databases
 
     string recentLabels[5] = { "RECENT1", "RECENT2", "RECENT3", "RECENT4", "RECENT5" };
@@ -162,13 +193,12 @@ class MainWindow : public QMainWindow
   //QSize sizeHint(void) const override;
 
     QLabel    *createTerminalLabel(void);
-    QTextEdit *createTerminalWindow(void);
+    TerminalWindow *createTerminalWindow(void);
     QLineEdit *createLastCommandWindow(void);
     QTextEdit *createCommandNotesWindow(void);
 
     QString getDatabaseFile(QFileDialog::AcceptMode acceptMode, QFileDialog::FileMode fileMode);
 
-    void setCategories(void);
     void getDBName(void);
     void setDBName(bool modified);
     void resetDB(void);
@@ -178,16 +208,25 @@ class MainWindow : public QMainWindow
     void translateMainWindow();
     void changeEvent(QEvent *event) override;
     void closeEvent(QCloseEvent *event) override;
+    void recordChanged(int cat, int num) override;
+    void recordRemoved(int cat, int num, bool lastCmd) override;
+    void recordsReset() override;
 
   private slots:
     void setCommands(int);
     void setCommandSelected(int);
     void setCommandEntered(QString *);
+    void displayProfile();
+    void filterEdited(const QString &text);
+    void filterStart();
+    void filterResults(QString text, QStringList categories, QStringList commands);
+    void filterActivated(const QModelIndex &index);
   //..
     void buttonClearPressed();
     void buttonAddPressed();
     void buttonModifyPressed();
     void buttonDeletePressed();
+    void buttonRunPressed();
   //..
     void dbMenuNew(void);
     void dbMenuOpen(void);
@@ -0,0 +1,285 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include "outputdecoder.h"
+
+// unicode of the characters 80h to FFh of code page 850 (IBM 850), which is used by the Windows console
+const ushort OutputDecoder::ibm850[128] = {
+    0x00C7, 0x00FC, 0x00E9, 0x00E2, 0x00E4, 0x00E0, 0x00E5, 0x00E7, 0x00EA, 0x00EB, 0x00E8, 0x00EF, 0x00EE, 0x00EC, 0x00C4, 0x00C5,
+    0x00C9, 0x00E6, 0x00C6, 0x00F4, 0x00F6, 0x00F2, 0x00FB, 0x00F9, 0x00FF, 0x00D6, 0x00DC, 0x00F8, 0x00A3, 0x00D8, 0x00D7, 0x0192,
+    0x00E1, 0x00ED, 0x00F3, 0x00FA, 0x00F1, 0x00D1, 0x00AA, 0x00BA, 0x00BF, 0x00AE, 0x00AC, 0x00BD, 0x00BC, 0x00A1, 0x00AB, 0x00BB,
+    0x2591, 0x2592, 0x2593, 0x2502, 0x2524, 0x00C1, 0x00C2, 0x00C0, 0x00A9, 0x2563, 0x2551, 0x2557, 0x255D, 0x00A2, 0x00A5, 0x2510,
+    0x2514, 0x2534, 0x252C, 0x251C, 0x2500, 0x253C, 0x00E3, 0x00C3, 0x255A, 0x2554, 0x2569, 0x2566, 0x2560, 0x2550, 0x256C, 0x00A4,
+    0x00F0, 0x00D0, 0x00CA, 0x00CB, 0x00C8, 0x0131, 0x00CD, 0x00CE, 0x00CF, 0x2518, 0x250C, 0x2588, 0x2584, 0x00A6, 0x00CC, 0x2580,
+    0x00D3, 0x00DF, 0x00D4, 0x00D2, 0x00F5, 0x00D5, 0x00B5, 0x00FE, 0x00DE, 0x00DA, 0x00DB, 0x00D9, 0x00FD, 0x00DD, 0x00AF, 0x00B4,
+    0x00AD, 0x00B1, 0x2017, 0x00BE, 0x00B6, 0x00A7, 0x00F7, 0x00B8, 0x00B0, 0x00A8, 0x00B7, 0x00B9, 0x00B3, 0x00B2, 0x25A0, 0x00A0 };
+
+/**
+ * @brief OutputDecoder::OutputDecoder
+ *   Constructor of the class OutputDecoder.
+ * @param enc  encoding of the process output
+ */
+OutputDecoder::OutputDecoder(Encoding enc)
+{
+    encoding = enc;
+
+    // the code page 850 is converted by the table; no decoder is needed
+    if (encoding == UTF8) {
+      #if QT_VERSION >= QT_VERSION_CHECK(6,0,0)
+        decoder = new QStringDecoder(QStringDecoder::Utf8);
+      #else
+        decoder = QTextCodec::codecForName("UTF-8")->makeDecoder();
+      #endif
+    }
+
+    return;
+}
+
+/**
+ * @brief OutputDecoder::~OutputDecoder
+ *   Destructor of the class OutputDecoder.
+ */
+OutputDecoder::~OutputDecoder()
+{
+    delete decoder;
+    return;
+}
+
+/**
+ * @brief OutputDecoder::reset
+ *   Resets the state of the decoder, e.g. before the output of a new process is converted.
+ */
+void OutputDecoder::reset()
+{
+    if (encoding == UTF8) {
+      #if QT_VERSION >= QT_VERSION_CHECK(6,0,0)
+        decoder->resetState();
+      #else
+        delete decoder;
+        decoder = QTextCodec::codecForName("UTF-8")->makeDecoder();
+      #endif
+    }
+
+    tailSize = 0;
+
+    return;
+}
+
+/**
+ * @brief OutputDecoder::decode
+ *   Converts a data block of the process output to unicode.
+ * @param data
+ * @return converted data
+ */
+QString OutputDecoder::decode(const QByteArray &data)
+{
+    QString strData;
+
+    // Pure ASCII and no UTF-8 sequence left incomplete by the last block?
+    // => the conversion doesn't need the decoder (fromLatin1 is vectorized by Qt)
+    if (isAscii(data.constData(),data.size()) && (encoding != UTF8 || seqComplete())) {
+        strData = QString::fromLatin1(data);
+    } else if (encoding == IBM850) {
+        strData.resize(data.size());
+        QChar *str = strData.data();
+        for (qsizetype pos = 0; pos < data.size(); pos++) {
+            byte ch = data.at(pos);
+            str[pos] = QChar((ch < 0x80) ? (ushort)ch : ibm850[ch-0x80]);
+        }
+    } else {
+      #if QT_VERSION >= QT_VERSION_CHECK(6,0,0)
+        strData = decoder->decode(data);
+      #else
+        strData = decoder->toUnicode(data);
+      #endif
+    }
+
+    setTail(data);
+
+    return strData;
+}
+
+/**
+ * @brief OutputDecoder::isAscii
+ *   Checks if a data block contains ASCII characters only. 16 bytes (SSE2) or
+ *   8 bytes are checked at once.
+ * @param data
+ * @param size
+ * @return true = data contains ASCII characters only
+ */
+bool OutputDecoder::isAscii(const char *data, qsizetype size)
+{
+    qsizetype pos = 0;
+
+  #ifdef __SSE2__
+    for (; pos + 16 <= size; pos+= 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)(data + pos));
+        if (_mm_movemask_epi8(chunk) != 0) return false;  // bit 7 of a byte set
+    }
+  #endif
+
+    for (; pos + 8 <= size; pos+= 8) {
+        quint64 chunk;
+        memcpy(&chunk,data + pos,8);
+        if ((chunk & Q_UINT64_C(0x8080808080808080)) != 0) return false;
+    }
+
+    for (; pos < size; pos++) {
+        if ((byte)data[pos] >= 0x80) return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief OutputDecoder::setTail
+ *   Stores the last bytes of the converted data for checking the completeness
+ *   of the last UTF-8 sequence.
+ * @param data
+ */
+void OutputDecoder::setTail(const QByteArray &data)
+{
+    if (data.size() >= 4) {
+        memcpy(tail,data.constData() + data.size() - 4,4);
+        tailSize = 4;
+    } else {
+        for (qsizetype pos = 0; pos < data.size(); pos++) {
+            if (tailSize == 4) {
+                memmove(tail,tail + 1,3);
+                tailSize--;
+            }
+            tail[tailSize++] = data.at(pos);
+        }
+    }
+
+    return;
+}
+
+/**
+ * @brief OutputDecoder::seqComplete
+ * @return true = the converted data ends with a complete (or invalid) UTF-8 sequence,
+ *         so the decoder has no state left
+ */
+bool OutputDecoder::seqComplete()
+{
+    int pos = tailSize - 1;
+
+    // search the start byte of the last sequence
+    while (pos >= 0 && ((byte)tail[pos] & 0xC0) == 0x80) {
+        pos--;
+    }
+
+    if (pos < 0) return true;  // only continuation bytes => invalid sequence
+
+    byte ch = tail[pos];
+    int  len;
+
+    if (ch < 0x80)      len = 1;
+    else if (ch < 0xC0) len = 1;  // invalid start byte
+    else if (ch < 0xE0) len = 2;
+    else if (ch < 0xF0) len = 3;
+    else if (ch < 0xF8) len = 4;
+    else                len = 1;  // invalid start byte
+
+    return (tailSize - pos) >= len;
+}
+
+/**
+ * @brief OutputDecoder::sampleBytes
+ *   Counts the bytes indicating binary data: NUL and the control characters not occurring in
+ *   text (all below 20h except BEL, BS, TAB, LF, VT, FF, CR and ESC) and, for UTF-8, the bytes
+ *   not part of a valid sequence. A sequence split at the end of the data isn't counted.
+ * @param data
+ * @param size
+ * @param utf8      true = the invalid UTF-8 sequences are counted
+ * @param controls  number of control characters is added
+ * @param invalid   number of invalid bytes is added
+ */
+void OutputDecoder::sampleBytes(const char *data, qsizetype size, bool utf8, qsizetype &controls, qsizetype &invalid)
+{
+    const byte *ptr = (const byte *)data;
+    qsizetype   pos = 0;
+
+    while (pos < size) {
+        byte chr = ptr[pos];
+
+        if (chr < 0x20) {
+            if ((chr < 0x07 || chr > 0x0d) && chr != 0x1b) controls++;
+            pos++;
+            continue;
+        }
+
+        if (chr < 0x80 || !utf8) {
+            pos++;
+            continue;
+        }
+
+        int len = (chr >= 0xc2 && chr <= 0xdf) ? 2 : (chr >= 0xe0 && chr <= 0xef) ? 3 : (chr >= 0xf0 && chr <= 0xf4) ? 4 : 0;
+
+        if (len == 0) {
+            invalid++;
+            pos++;
+            continue;
+        }
+
+        if (pos + len > size) break;
+
+        int num = 1;
+        while (num < len && (ptr[pos+num] & 0xc0) == 0x80) num++;
+
+        if (num < len) {
+            invalid++;
+            pos++;
+            continue;
+        }
+
+        pos+= len;
+    }
+
+    return;
+}
+
+/**
+ * @brief OutputDecoder::encode
+ *   Converts unicode to the encoding of a process. Characters not contained in
+ *   code page 850 are replaced by '?'.
+ * @param text
+ * @param enc
+ * @return converted text
+ */
+QByteArray OutputDecoder::encode(const QString &text, Encoding enc)
+{
+    if (enc == UTF8) return text.toUtf8();
+
+    QByteArray data(text.size(),'?');
+
+    for (qsizetype pos = 0; pos < text.size(); pos++) {
+        ushort chr = text.at(pos).unicode();
+        if (chr < 0x80) {
+            data[pos] = (char)chr;
+            continue;
+        }
+        for (int num = 0; num < 128; num++) {
+            if (ibm850[num] == chr) {
+                data[pos] = (char)(0x80+num);
+                break;
+            }
+        }
+    }
+
+    return data;
+}
@@ -0,0 +1,80 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef OUTPUTDECODER_H
+#define OUTPUTDECODER_H
+
+#include <cstring>
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+#if QT_VERSION >= QT_VERSION_CHECK(6,0,0)
+    #include <QStringDecoder>
+#else
+    #include <QTextCodec>
+#endif
+#ifdef __SSE2__
+    #include <emmintrin.h>
+#endif
+#include "main.h"
+
+/**
+ * @brief OutputDecoder
+ *   Converts the output of a process to unicode. The decoder keeps its state between
+ *   the converted data blocks, so characters split between two blocks are converted
+ *   correctly. Pure ASCII blocks are converted without the UTF-8 decoder. The input of a
+ *   process is converted to the same encoding by encode().
+ */
+class OutputDecoder
+{
+    typedef unsigned char byte;
+
+    static const ushort ibm850[128];  // unicode of the characters 80h to FFh of code page 850
+
+  public:
+    enum Encoding { UTF8, IBM850 };
+
+  private:
+    Encoding encoding;
+
+  #if QT_VERSION >= QT_VERSION_CHECK(6,0,0)
+    QStringDecoder *decoder = nullptr;
+  #else
+    QTextDecoder   *decoder = nullptr;
+  #endif
+
+    char tail[4];        // last bytes of the converted data
+    int  tailSize = 0;
+
+    static bool isAscii(const char *data, qsizetype size);
+    bool seqComplete();  // true if the converted data ends with a complete UTF-8 sequence
+    void setTail(const QByteArray &data);
+
+  public:
+    explicit OutputDecoder(Encoding enc = UTF8);
+    ~OutputDecoder();
+
+    QString decode(const QByteArray &data);  // converts a data block to unicode
+    void reset();                            // resets the state of the decoder
+
+    static QByteArray encode(const QString &text, Encoding enc);  // converts unicode to the encoding of the process input
+
+    // counts the control characters not used in text and the bytes not part of a valid UTF-8 sequence
+    static void sampleBytes(const char *data, qsizetype size, bool utf8, qsizetype &controls, qsizetype &invalid);
+};
+
+#endif // OUTPUTDECODER_H
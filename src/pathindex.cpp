@@ -0,0 +1,168 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include "pathindex.h"
+
+using namespace std;
+
+/**
+ * @brief PathIndex::PathIndex
+ *   Constructor of the class PathIndex. The directories of PATH are watched for changes.
+ * @param parent
+ */
+PathIndex::PathIndex(QObject *parent) : QThread(parent)
+{
+    QStringList pathDirs = QString::fromLocal8Bit(qgetenv("PATH")).split(QDir::listSeparator());
+
+    for (int idx = 0; idx < pathDirs.size(); idx++) {
+        if (!pathDirs.at(idx).isEmpty() && !dirs.contains(pathDirs.at(idx)) && QDir(pathDirs.at(idx)).exists()) {
+            dirs << pathDirs.at(idx);
+        }
+    }
+
+    watcher = new QFileSystemWatcher(this);
+
+    if (!dirs.isEmpty()) {
+        watcher->addPaths(dirs);
+    }
+
+    connect(watcher,SIGNAL(directoryChanged(QString)),this,SLOT(directoryChanged(QString)));
+    connect(this,SIGNAL(finished()),this,SLOT(scanFinished()));
+
+    return;
+}
+
+/**
+ * @brief PathIndex::~PathIndex
+ *   Destructor of the class PathIndex. A running scan is stopped.
+ */
+PathIndex::~PathIndex()
+{
+    requestInterruption();
+    wait();
+
+    return;
+}
+
+/**
+ * @brief PathIndex::build
+ *   Starts building the index in the thread of the class.
+ */
+void PathIndex::build()
+{
+    if (isRunning()) {
+        rescan = true;
+    } else {
+        start(QThread::LowPriority);
+    }
+
+    return;
+}
+
+/**
+ * @brief PathIndex::run
+ *   Scans the directories of PATH for executables. Under Windows the executables are
+ *   identified by the extensions of PATHEXT; the extension isn't part of the command.
+ */
+void PathIndex::run()
+{
+    QStringList found;
+    QStringList extensions;
+    QFileInfoList entries;
+
+  #ifdef Q_OS_WIN
+    extensions = QString::fromLocal8Bit(qgetenv("PATHEXT")).toLower().split(';');
+    if (extensions.size() < 2) extensions = QStringList() << ".com" << ".exe" << ".bat" << ".cmd";
+  #endif
+
+    for (int idx = 0; idx < dirs.size() && !isInterruptionRequested(); idx++) {
+        entries = QDir(dirs.at(idx)).entryInfoList(QDir::Files|QDir::Executable);
+        for (int num = 0; num < entries.size(); num++) {
+          #ifdef Q_OS_WIN
+            if (!extensions.contains("."+entries.at(num).suffix().toLower())) continue;
+            found << entries.at(num).completeBaseName();
+          #else
+            found << entries.at(num).fileName();
+          #endif
+        }
+    }
+
+    // sorted index without duplicates; the first directory of PATH containing a command is used anyway
+    std::sort(found.begin(),found.end());
+    found.removeDuplicates();
+
+    QMutexLocker locker(&scanMutex);
+    scanned = found;
+
+    return;
+}
+
+/**
+ * @brief PathIndex::scanFinished
+ *   Takes over the index built by run(). Changes during the scan start a new scan.
+ */
+void PathIndex::scanFinished()
+{
+    {
+        QMutexLocker locker(&scanMutex);
+        commands = scanned;
+        scanned.clear();
+    }
+
+  #ifdef DEBUG
+    cout << "PATH index: " << commands.size() << " commands.\n";
+  #endif
+
+    if (rescan && !isInterruptionRequested()) {
+        rescan = false;
+        start(QThread::LowPriority);
+    }
+
+    return;
+}
+
+/**
+ * @brief PathIndex::directoryChanged
+ *   Is called if a file is added to or removed from a directory of PATH.
+ * @param path
+ */
+void PathIndex::directoryChanged(const QString &path)
+{
+    Q_UNUSED(path);
+
+    build();
+
+    return;
+}
+
+/**
+ * @brief PathIndex::complete
+ *   Determines the executables starting with a prefix by a binary search in the index.
+ * @param prefix
+ * @return sorted executables
+ */
+QStringList PathIndex::complete(const QString &prefix)
+{
+    QStringList result;
+    QStringList::const_iterator iter = std::lower_bound(commands.constBegin(),commands.constEnd(),prefix);
+
+    for (; iter != commands.constEnd() && iter->startsWith(prefix); ++iter) {
+        result << *iter;
+    }
+
+    return result;
+}
@@ -0,0 +1,68 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef PATHINDEX_H
+#define PATHINDEX_H
+
+#include <algorithm>
+#include <iostream>
+#include <QDir>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+#include "main.h"
+
+/**
+ * @brief PathIndex
+ *   Sorted index of the executables in the directories of the environment variable PATH.
+ *   The directories are scanned in the thread of the class; the index is rebuilt if a
+ *   directory changes. The lookup of the commands starting with a prefix is a binary
+ *   search in the sorted index.
+ */
+class PathIndex : public QThread
+{
+    Q_OBJECT
+
+    QFileSystemWatcher *watcher;
+
+    QStringList dirs;      // directories of PATH
+    QStringList commands;  // sorted executables; used in the thread of the owner only
+    QStringList scanned;   // executables found by run()
+
+    QMutex scanMutex;      // protects scanned
+
+    bool rescan = false;   // a directory changed while the index was built
+
+    void run() override;
+
+  private slots:
+    void directoryChanged(const QString &path);
+    void scanFinished();
+
+  public:
+    explicit PathIndex(QObject *parent = nullptr);
+    ~PathIndex();
+
+    void build();                                   // starts building the index
+    QStringList complete(const QString &prefix);    // returns the sorted executables starting with the prefix
+};
+
+#endif // PATHINDEX_H
@@ -0,0 +1,317 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include "ptyprocess.h"
+
+using namespace std;
+
+/**
+ * @brief PtyProcess::PtyProcess
+ *   Constructor of the class PtyProcess.
+ * @param parent
+ */
+PtyProcess::PtyProcess(QObject *parent) : QObject(parent)
+{
+    waitTimer = new QTimer(this);
+    waitTimer->setInterval(50);
+
+    wallTimer = new QTimer(this);
+    wallTimer->setSingleShot(true);
+
+    connect(waitTimer,SIGNAL(timeout()),this,SLOT(waitExit()));
+    connect(wallTimer,SIGNAL(timeout()),this,SIGNAL(timedOut_signal()));
+
+    return;
+}
+
+/**
+ * @brief PtyProcess::~PtyProcess
+ *   Destructor of the class PtyProcess. A running program is killed.
+ */
+PtyProcess::~PtyProcess()
+{
+  #ifdef Q_OS_UNIX
+    if (pid > 0) {
+        ::kill(-(pid_t)pid,SIGKILL);
+        waitpid((pid_t)pid,nullptr,0);
+    }
+    if (masterFd >= 0) ::close(masterFd);
+  #endif
+
+    return;
+}
+
+/**
+ * @brief PtyProcess::setLimits
+ *   Sets the limits of the program. The wall clock time is watched by a timer;
+ *   timedOut_signal() is emitted if it expires.
+ * @param lim
+ */
+void PtyProcess::setLimits(const LimitedProcess::Limits &lim)
+{
+    limits = lim;
+
+    return;
+}
+
+/**
+ * @brief PtyProcess::start
+ *   Starts a program in a new pseudo terminal. The terminal type is "dumb", because the
+ *   terminal window doesn't emulate the cursor movements of full screen programs.
+ * @param program
+ * @param arguments
+ * @param workDir
+ * @param cols  number of columns of the terminal
+ * @param rows  number of rows of the terminal
+ * @return false = the pseudo terminal couldn't be created
+ */
+bool PtyProcess::start(const QString &program, const QStringList &arguments, const QString &workDir, int cols, int rows)
+{
+  #ifdef Q_OS_UNIX
+    struct winsize size;
+    vector<QByteArray> args;
+    vector<char *>     argv;
+    vector<QByteArray> envs;
+    vector<char *>     envp;
+    QByteArray         dir = workDir.toLocal8Bit();
+    QByteArray         path;
+    QStringList        environment = QProcessEnvironment::systemEnvironment().toStringList();
+
+    // the arguments, the environment and the path of the program are prepared before fork(), so the
+    // child only calls async-signal-safe functions; other threads may hold locks of the C library
+    args.push_back(program.toLocal8Bit());
+    for (int idx = 0; idx < arguments.size(); idx++) {
+        args.push_back(arguments.at(idx).toLocal8Bit());
+    }
+    for (size_t idx = 0; idx < args.size(); idx++) {
+        argv.push_back(args[idx].data());
+    }
+    argv.push_back(nullptr);
+
+    for (int idx = 0; idx < environment.size(); idx++) {
+        if (!environment.at(idx).startsWith("TERM=")) envs.push_back(environment.at(idx).toLocal8Bit());
+    }
+    envs.push_back("TERM=dumb");
+    for (size_t idx = 0; idx < envs.size(); idx++) {
+        envp.push_back(envs[idx].data());
+    }
+    envp.push_back(nullptr);
+
+    // a program without a directory is searched in PATH; a relative path is relative to the working directory
+    path = program.contains('/') ? program.toLocal8Bit() : QStandardPaths::findExecutable(program).toLocal8Bit();
+    if (path.isEmpty()) path = program.toLocal8Bit();
+
+    size.ws_col    = cols;
+    size.ws_row    = rows;
+    size.ws_xpixel = 0;
+    size.ws_ypixel = 0;
+
+    pid_t child = forkpty(&masterFd,nullptr,nullptr,&size);
+
+    if (child < 0) {
+        masterFd = -1;
+        return false;
+    }
+
+    if (child == 0) {
+        // child process: the slave side of the terminal is standard input, output and error
+        LimitedProcess::setResourceLimits(limits);
+        if (chdir(dir.constData()) != 0) _exit(126);
+        execve(path.constData(),argv.data(),envp.data());
+        _exit(127);
+    }
+
+    pid = child;
+
+    fcntl(masterFd,F_SETFL,fcntl(masterFd,F_GETFL) | O_NONBLOCK);
+    fcntl(masterFd,F_SETFD,FD_CLOEXEC);
+
+    notifier = new QSocketNotifier(masterFd,QSocketNotifier::Read,this);
+
+    connect(notifier,SIGNAL(activated(QSocketDescriptor,QSocketNotifier::Type)),this,SLOT(readMaster()));
+
+    writeNotifier = new QSocketNotifier(masterFd,QSocketNotifier::Write,this);
+    writeNotifier->setEnabled(false);
+
+    connect(writeNotifier,SIGNAL(activated(QSocketDescriptor,QSocketNotifier::Type)),this,SLOT(writeQueued()));
+
+    if (limits.timeout > 0) wallTimer->start(limits.timeout*1000);
+
+    return true;
+  #else
+    Q_UNUSED(program);
+    Q_UNUSED(arguments);
+    Q_UNUSED(workDir);
+    Q_UNUSED(cols);
+    Q_UNUSED(rows);
+    return false;
+  #endif
+}
+
+/**
+ * @brief PtyProcess::readMaster
+ *   Reads the output of the program. If the terminal is closed by the program, the
+ *   exit status is polled.
+ */
+void PtyProcess::readMaster()
+{
+  #ifdef Q_OS_UNIX
+    QByteArray data(PTYREADSIZE,Qt::Uninitialized);
+
+    ssize_t size = ::read(masterFd,data.data(),PTYREADSIZE);
+
+    if (size > 0) {
+        data.truncate(size);
+        emit output_signal(data);
+        return;
+    }
+
+    if (size < 0 && (errno == EAGAIN || errno == EINTR)) return;
+
+    // The terminal is closed (EIO under Linux)? => no more output
+    notifier->setEnabled(false);
+    notifier->deleteLater();
+    notifier = nullptr;
+
+    writeNotifier->setEnabled(false);
+    writeNotifier->deleteLater();
+    writeNotifier = nullptr;
+    input.clear();
+
+    ::close(masterFd);
+    masterFd = -1;
+
+    waitExit();
+    if (pid > 0) waitTimer->start();
+  #endif
+
+    return;
+}
+
+/**
+ * @brief PtyProcess::waitExit
+ *   Determines the exit status of the program without blocking.
+ */
+void PtyProcess::waitExit()
+{
+  #ifdef Q_OS_UNIX
+    int status;
+
+    if (pid <= 0 || waitpid((pid_t)pid,&status,WNOHANG) == 0) return;
+
+    pid = -1;
+    waitTimer->stop();
+    wallTimer->stop();
+
+    if (WIFEXITED(status)) {
+        emit finished_signal(WEXITSTATUS(status),false);
+    } else {
+        emit finished_signal(-1,true);
+    }
+  #endif
+
+    return;
+}
+
+/**
+ * @brief PtyProcess::write
+ *   Queues input of the program and writes as much as the terminal takes. If the input
+ *   buffer of the terminal is full, the rest is written when it's writable again, so
+ *   large pastes aren't truncated.
+ * @param data  input of the program; the terminal echoes the input
+ */
+void PtyProcess::write(const QByteArray &data)
+{
+    if (masterFd < 0) return;
+
+    input+= data;
+
+    writeQueued();
+
+    return;
+}
+
+/**
+ * @brief PtyProcess::writeQueued
+ *   Writes the queued input to the terminal.
+ */
+void PtyProcess::writeQueued()
+{
+  #ifdef Q_OS_UNIX
+    ssize_t size = 0;
+    int     written = 0;
+
+    if (masterFd < 0) return;
+
+    while (written < input.size()) {
+        size = ::write(masterFd,input.constData()+written,input.size()-written);
+        if (size < 0 && errno == EINTR) continue;
+        if (size <= 0) break;
+        written+= (int)size;
+    }
+
+    input.remove(0,written);
+
+    // input buffer of the terminal full? => the notifier continues; other errors discard the input
+    if (size < 0 && errno != EAGAIN && errno != EWOULDBLOCK) input.clear();
+
+    writeNotifier->setEnabled(!input.isEmpty());
+  #endif
+
+    return;
+}
+
+/**
+ * @brief PtyProcess::setWindowSize
+ * @param cols
+ * @param rows
+ */
+void PtyProcess::setWindowSize(int cols, int rows)
+{
+  #ifdef Q_OS_UNIX
+    struct winsize size;
+
+    if (masterFd < 0) return;
+
+    size.ws_col    = cols;
+    size.ws_row    = rows;
+    size.ws_xpixel = 0;
+    size.ws_ypixel = 0;
+
+    ioctl(masterFd,TIOCSWINSZ,&size);
+  #else
+    Q_UNUSED(cols);
+    Q_UNUSED(rows);
+  #endif
+
+    return;
+}
+
+/**
+ * @brief PtyProcess::sendSignal
+ * @param sig
+ */
+void PtyProcess::sendSignal(int sig)
+{
+  #ifdef Q_OS_UNIX
+    if (pid > 0) ::kill(-(pid_t)pid,sig);
+  #else
+    Q_UNUSED(sig);
+  #endif
+
+    return;
+}
@@ -0,0 +1,98 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef PTYPROCESS_H
+#define PTYPROCESS_H
+
+#include <iostream>
+#include <vector>
+#include <QByteArray>
+#include <QObject>
+#include <QProcessEnvironment>
+#include <QSocketNotifier>
+#include <QStandardPaths>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+#include "limitedprocess.h"
+#include "main.h"
+
+#ifdef Q_OS_UNIX
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <signal.h>
+    #include <sys/ioctl.h>
+    #include <sys/types.h>
+    #include <sys/wait.h>
+    #include <unistd.h>
+  #ifdef Q_OS_MACOS
+    #include <util.h>
+  #else
+    #include <pty.h>
+  #endif
+#endif
+
+/**
+ * @brief PtyProcess
+ *   Process running in a pseudo terminal. The program sees a terminal as standard input and
+ *   output, so it writes its output line by line and may prompt the user. The output is read
+ *   from the master side of the pseudo terminal as soon as a QSocketNotifier reports it.
+ *   The limits of a LimitedProcess apply to the program as well, except for the cgroup.
+ *   Only available under Unix.
+ */
+class PtyProcess : public QObject
+{
+    Q_OBJECT
+
+    #define PTYREADSIZE 65536  // maximum number of bytes read per notification
+
+    int  masterFd = -1;  // master side of the pseudo terminal
+    long pid      = -1;  // process id of the program; the program is leader of its process group
+
+    QSocketNotifier *notifier = nullptr;
+    QSocketNotifier *writeNotifier = nullptr;  // reports the terminal writable again
+    QTimer          *waitTimer;  // polls the exit of the program after the terminal is closed
+    QTimer          *wallTimer;  // watches the wall clock time of the program
+
+    LimitedProcess::Limits limits;  // limits of the program; set in the child process before exec()
+
+    QByteArray input;    // input not yet written to the terminal
+
+  private slots:
+    void readMaster();
+    void writeQueued();
+    void waitExit();
+
+  public:
+    explicit PtyProcess(QObject *parent = nullptr);
+    ~PtyProcess();
+
+    void setLimits(const LimitedProcess::Limits &lim);  // must be called before start()
+    bool start(const QString &program, const QStringList &arguments, const QString &workDir, int cols, int rows);
+    void write(const QByteArray &data);        // queues input of the program for the terminal
+    void setWindowSize(int cols, int rows);    // window size of the terminal; the program gets SIGWINCH
+    void sendSignal(int sig);                  // sends a signal to the process group of the program
+    bool isRunning() { return pid > 0; }
+    long processId() { return pid; }
+
+  signals:
+    void output_signal(QByteArray);
+    void finished_signal(int exitCode, bool crashed);
+    void timedOut_signal();
+};
+
+#endif // PTYPROCESS_H
@@ -0,0 +1,235 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include "resultcache.h"
+
+using namespace std;
+
+/**
+ * @brief ResultCache::ResultCache
+ *   Constructor of the class ResultCache.
+ */
+ResultCache::ResultCache()
+{
+    return;
+}
+
+/**
+ * @brief ResultCache::setDirectory
+ * @param dir  cache directory; created on the first output stored
+ * @param max  maximum total size of the cached outputs in bytes; 0 = default
+ */
+void ResultCache::setDirectory(const QString &dir, qint64 max)
+{
+    dirName = dir;
+
+    if (max > 0) maxSize = max;
+
+    return;
+}
+
+/**
+ * @brief ResultCache::load
+ *   Reads the sizes and the times of the last use of the cached outputs. The directory is
+ *   read only once.
+ */
+void ResultCache::load()
+{
+    if (loaded) return;
+
+    loaded = true;
+
+    QFileInfoList files = QDir(dirName).entryInfoList(QDir::Files);
+
+    for (int idx = 0; idx < files.size(); idx++) {
+        Entry entry;
+        entry.size = files.at(idx).size();
+        entry.used = files.at(idx).lastModified().toMSecsSinceEpoch();
+        entries.insert(files.at(idx).fileName(),entry);
+        totalSize+= entry.size;
+    }
+
+    evict();
+
+    return;
+}
+
+/**
+ * @brief ResultCache::evict
+ *   Removes the least recently used outputs until the total size is below the maximum.
+ */
+void ResultCache::evict()
+{
+    while (totalSize > maxSize && !entries.isEmpty()) {
+        QHash<QString,Entry>::const_iterator oldest = entries.constBegin();
+        for (QHash<QString,Entry>::const_iterator iter = entries.constBegin(); iter != entries.constEnd(); ++iter) {
+            if (iter.value().used < oldest.value().used) oldest = iter;
+        }
+        QFile::remove(filePath(oldest.key()));
+        totalSize-= oldest.value().size;
+        entries.remove(oldest.key());
+    }
+
+    return;
+}
+
+/**
+ * @brief ResultCache::key
+ *   Hashes the command, the working directory and the sorted environment; an output is
+ *   only replayed in the same context.
+ * @param cmd
+ * @param workDir
+ * @return key of the cached output
+ */
+QString ResultCache::key(const QString &cmd, const QString &workDir)
+{
+    QStringList env = QProcessEnvironment::systemEnvironment().toStringList();
+
+    env.sort();
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    hash.addData(cmd.toUtf8());
+    hash.addData(QByteArray(1,'\0'));
+    hash.addData(workDir.toUtf8());
+    hash.addData(QByteArray(1,'\0'));
+    hash.addData(env.join('\n').toUtf8());
+
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+/**
+ * @brief ResultCache::parseTtl
+ *   Reads the time to live of the output of a command from a line of its notes, e.g. "@cache=60".
+ * @param line
+ * @param ttl  time to live in seconds; replaced if the line is a cache annotation
+ * @return true if the line is a cache annotation
+ */
+bool ResultCache::parseTtl(const QString &line, int &ttl)
+{
+    QString text = line.trimmed();
+
+    if (!text.startsWith("@cache=")) return false;
+
+    bool ok    = false;
+    int  value = text.mid(7).trimmed().toInt(&ok);
+
+    if (!ok || value < 0) return false;
+
+    ttl = value;
+
+    return true;
+}
+
+/**
+ * @brief ResultCache::lookup
+ *   Reads a cached output. A hit becomes the most recently used output.
+ * @param key
+ * @param ttl       time to live in seconds
+ * @param output
+ * @param exitCode
+ * @param age       age of the output in seconds
+ * @return true if the output was found and isn't expired
+ */
+bool ResultCache::lookup(const QString &key, int ttl, QString &output, int &exitCode, qint64 &age)
+{
+    load();
+
+    if (!entries.contains(key)) return false;
+
+    QFile file(filePath(key));
+
+    if (!file.open(QIODevice::ReadWrite)) return false;
+
+    // header: magic, time of creation, exit code
+    QByteArray magic   = file.readLine().trimmed();
+    qint64     created = file.readLine().trimmed().toLongLong();
+    int        code    = file.readLine().trimmed().toInt();
+
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    if (magic != CACHEMAGIC || now - created > (qint64)ttl*1000) {
+        file.close();
+        return false;
+    }
+
+    output   = QString::fromUtf8(file.readAll());
+    exitCode = code;
+    age      = (now - created) / 1000;
+
+    file.setFileTime(QDateTime::currentDateTime(),QFileDevice::FileModificationTime);
+    file.close();
+
+    entries[key].used = now;
+
+    return true;
+}
+
+/**
+ * @brief ResultCache::store
+ *   Writes an output to the cache and removes the least recently used outputs if the cache
+ *   exceeds its size.
+ * @param key
+ * @param output
+ * @param exitCode
+ * @return
+ *   0 = output stored
+ *   1 = could not create the cache directory
+ *   2 = could not write the file
+ *   3 = output larger than the cache
+ */
+ResultCache::byte ResultCache::store(const QString &key, const QString &output, int exitCode)
+{
+    load();
+
+    QByteArray data = QByteArray(CACHEMAGIC)+"\n"+
+                      QByteArray::number(QDateTime::currentMSecsSinceEpoch())+"\n"+
+                      QByteArray::number(exitCode)+"\n"+
+                      output.toUtf8();
+
+    if (data.size() > maxSize) return 3;
+
+    if (!QDir().mkpath(dirName)) return 1;
+
+    QFile file(filePath(key));
+
+    if (!file.open(QIODevice::WriteOnly|QIODevice::Truncate) || file.write(data) != data.size()) {
+        file.close();
+        file.remove();
+        if (entries.contains(key)) {
+            totalSize-= entries.value(key).size;
+            entries.remove(key);
+        }
+        return 2;
+    }
+
+    file.close();
+
+    if (entries.contains(key)) totalSize-= entries.value(key).size;
+
+    Entry entry;
+
+    entry.size = data.size();
+    entry.used = QDateTime::currentMSecsSinceEpoch();
+
+    entries.insert(key,entry);
+    totalSize+= entry.size;
+
+    evict();
+
+    return 0;
+}
@@ -0,0 +1,75 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include <iostream>
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QProcessEnvironment>
+#include <QString>
+#include <QStringList>
+#include "main.h"
+
+/**
+ * @brief ResultCache
+ *   On-disk cache of the output of commands marked cacheable in the library. An output is
+ *   stored in a file of the cache directory named by the hash of the command, the working
+ *   directory and the environment. The total size of the files is bounded; the least recently
+ *   used outputs are removed first. The time of the last use is kept as modification time of
+ *   the file, so the order survives a restart.
+ */
+class ResultCache
+{
+    typedef unsigned char byte;
+
+    #define CACHEMAGIC "CMDLIB-CACHE 1"
+
+    // structure of a cached output
+    struct Entry {
+        qint64 size;  // size of the file
+        qint64 used;  // time of the last use in ms since the epoch
+    };
+
+    QString dirName;
+    qint64  maxSize = 52428800;  // maximum total size of the files in bytes
+    qint64  totalSize = 0;
+    bool    loaded = false;      // true if the cache directory is read
+
+    QHash<QString,Entry> entries;  // key -> cached output
+
+    void load();
+    void evict();
+    QString filePath(const QString &key) { return dirName+"/"+key; }
+
+  public:
+    ResultCache();
+
+    void setDirectory(const QString &dir, qint64 max);
+    static QString key(const QString &cmd, const QString &workDir);  // key of a command in a working directory
+    static bool parseTtl(const QString &line, int &ttl);             // reads a line "@cache=seconds" of the notes of a command
+    bool lookup(const QString &key, int ttl, QString &output, int &exitCode, qint64 &age);  // true if an output isn't older than ttl s
+    byte store(const QString &key, const QString &output, int exitCode);
+};
+
+#endif // RESULTCACHE_H
@@ -0,0 +1,221 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include "scrollbackindex.h"
+
+#define SCANCHUNK 1048576  // size of the portions scanned by a backward search
+
+/**
+ * @brief ScrollbackIndex::ScrollbackIndex
+ *   Constructor of the class ScrollbackIndex.
+ */
+ScrollbackIndex::ScrollbackIndex()
+{
+    return;
+}
+
+/**
+ * @brief ScrollbackIndex::appendLine
+ * @param line
+ */
+void ScrollbackIndex::appendLine(const string &line)
+{
+    lineStart.push_back(text.size());
+
+    text.append(line);
+    text.push_back('\n');
+
+    return;
+}
+
+/**
+ * @brief ScrollbackIndex::removeFirstLines
+ *   Removes the oldest lines. The offsets of the remaining lines are moved to the front.
+ * @param count
+ */
+void ScrollbackIndex::removeFirstLines(size_t count)
+{
+    if (count >= lineStart.size()) {
+        clear();
+        return;
+    }
+
+    size_t removed = lineStart.at(count);
+
+    text.erase(0,removed);
+    lineStart.erase(lineStart.begin(),lineStart.begin()+count);
+
+    for (size_t num = 0; num < lineStart.size(); num++) {
+        lineStart[num]-= removed;
+    }
+
+    return;
+}
+
+/**
+ * @brief ScrollbackIndex::replaceFirstLine
+ *   Replaces the oldest line. The offsets of the following lines are moved by the
+ *   difference of the lengths; the other lines aren't copied again.
+ * @param line  the line must not contain '\n'
+ */
+void ScrollbackIndex::replaceFirstLine(const string &line)
+{
+    if (lineStart.empty()) return;
+
+    size_t oldSize = ((lineStart.size() > 1) ? lineStart.at(1) : text.size()) - 1;
+
+    text.replace(0,oldSize,line);
+
+    for (size_t num = 1; num < lineStart.size(); num++) {
+        lineStart[num] = lineStart[num] - oldSize + line.size();
+    }
+
+    return;
+}
+
+/**
+ * @brief ScrollbackIndex::truncate
+ *   Removes the lines from a line to the end, e.g. if these lines were changed.
+ * @param lines  number of lines kept
+ */
+void ScrollbackIndex::truncate(size_t lines)
+{
+    if (lines >= lineStart.size()) return;
+
+    text.resize(lineStart.at(lines));
+    lineStart.resize(lines);
+
+    return;
+}
+
+/**
+ * @brief ScrollbackIndex::clear
+ */
+void ScrollbackIndex::clear()
+{
+    text.clear();
+    lineStart.clear();
+
+    return;
+}
+
+/**
+ * @brief ScrollbackIndex::scan
+ *   Searches the first occurrence of the needle in a range of the buffer. glibc's memmem()
+ *   uses SSE2/AVX2 for short needles and the two-way algorithm for long needles.
+ * @param start
+ * @param end
+ * @param needle  not empty
+ * @return first occurrence; nullptr = not found
+ */
+const char *ScrollbackIndex::scan(const char *start, const char *end, const string &needle)
+{
+    if (start >= end || (size_t)(end-start) < needle.size()) return nullptr;
+
+  #if defined(__GLIBC__) || defined(__APPLE__) || defined(__FreeBSD__)
+    return (const char *)memmem(start,end-start,needle.data(),needle.size());
+  #else
+    const char *found = std::search(start,end,needle.begin(),needle.end());
+    return (found == end) ? nullptr : found;
+  #endif
+}
+
+/**
+ * @brief ScrollbackIndex::lineAt
+ * @param offset
+ * @return number of the line containing the offset
+ */
+long ScrollbackIndex::lineAt(size_t offset)
+{
+    vector<size_t>::const_iterator iter = upper_bound(lineStart.begin(),lineStart.end(),offset);
+
+    return (long)(iter - lineStart.begin()) - 1;
+}
+
+/**
+ * @brief ScrollbackIndex::findLine
+ *   Searches the next line containing the needle. The needle never spans lines, because it
+ *   doesn't contain a new line. A backward search scans portions of about SCANCHUNK bytes
+ *   from the start line to the front and takes the last hit of the first portion with a hit.
+ * @param needle
+ * @param start     number of the line the search starts at; the line itself isn't searched
+ * @param backward  true = search the previous lines; false = search the following lines
+ * @return number of the line; -1 = not found
+ */
+long ScrollbackIndex::findLine(const string &needle, long start, bool backward)
+{
+    const char *base = text.data();
+    const char *found;
+    const char *last;
+
+    if (needle.empty() || lineStart.empty()) return -1;
+
+    if (!backward) {
+        if (start < -1) start = -1;
+        if (start+1 >= (long)lineStart.size()) return -1;
+        found = scan(base+lineStart.at(start+1),base+text.size(),needle);
+        return (found == nullptr) ? -1 : lineAt(found-base);
+    }
+
+    if (start > (long)lineStart.size()) start = (long)lineStart.size();
+
+    long chunkEnd = start;  // first line after the portion
+
+    while (chunkEnd > 0) {
+        // the portion starts at a line, so no hit is split between two portions
+        long chunkStart = lineAt(lineStart.at(chunkEnd-1) >= SCANCHUNK ? lineStart.at(chunkEnd-1) - SCANCHUNK : 0);
+        if (chunkStart >= chunkEnd) chunkStart = chunkEnd-1;
+
+        const char *end = base + ((chunkEnd < (long)lineStart.size()) ? lineStart.at(chunkEnd) : text.size());
+
+        last  = nullptr;
+        found = scan(base+lineStart.at(chunkStart),end,needle);
+        while (found != nullptr) {
+            last  = found;
+            found = scan(found+1,end,needle);
+        }
+
+        if (last != nullptr) return lineAt(last-base);
+
+        chunkEnd = chunkStart;
+    }
+
+    return -1;
+}
+
+/**
+ * @brief ScrollbackIndex::count
+ *   Counts the occurrences of the needle; overlapping occurrences are counted once.
+ * @param needle
+ * @return number of occurrences
+ */
+size_t ScrollbackIndex::count(const string &needle)
+{
+    size_t hits = 0;
+
+    if (needle.empty()) return 0;
+
+    const char *end   = text.data() + text.size();
+    const char *found = scan(text.data(),end,needle);
+
+    while (found != nullptr) {
+        hits++;
+        found = scan(found+needle.size(),end,needle);
+    }
+
+    return hits;
+}
@@ -0,0 +1,56 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef SCROLLBACKINDEX_H
+#define SCROLLBACKINDEX_H
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief ScrollbackIndex
+ *   Copy of the lines of the terminal window for the search in the scrollback. The lines
+ *   are stored one after another in one buffer separated by new lines; a table holds the
+ *   offset of every line. The buffer is scanned with memmem(), which compares many bytes
+ *   per step, and the table maps the offset of a hit to its line by a binary search.
+ *   Lines are appended as the output arrives and removed from the front with the scrollback.
+ */
+class ScrollbackIndex
+{
+    string text;                // lines separated by '\n'
+    vector<size_t> lineStart;   // offset of every line in text
+
+    const char *scan(const char *start, const char *end, const string &needle);  // first occurrence between start and end
+    long lineAt(size_t offset);                                                 // line containing the offset
+
+  public:
+    ScrollbackIndex();
+    void   appendLine(const string &line);   // appends a line; the line must not contain '\n'
+    void   removeFirstLines(size_t count);   // removes the oldest lines
+    void   replaceFirstLine(const string &line);  // replaces the oldest line, e.g. if its start was cut
+    void   truncate(size_t lines);           // keeps the first lines only
+    void   clear();
+    size_t lines() { return lineStart.size(); }
+    long   findLine(const string &needle, long start, bool backward = false);  // next line containing the needle; -1 = none
+    size_t count(const string &needle);      // number of occurrences of the needle
+};
+
+#endif // SCROLLBACKINDEX_H
@@ -0,0 +1,434 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include "sessionlog.h"
+
+using namespace std;
+
+/**
+ * @brief SessionLog::SessionLog
+ *   Constructor of the class SessionLog. The thread writing the log file is started.
+ * @param fn    filename of the log file
+ * @param max   maximum size of the log file in bytes; 0 = no rotation
+ * @param segs  number of compressed segments kept
+ * @param parent
+ */
+SessionLog::SessionLog(const QString &fn, qint64 max, int segs, QObject *parent) : QThread(parent)
+{
+    fileName = fn;
+    maxSize  = max;
+    segments = segs;
+
+    // table of the CRC-32 used by gzip (polynomial 0xEDB88320)
+    for (quint32 num = 0; num < 256; num++) {
+        quint32 crc = num;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : (crc >> 1);
+        }
+        crcTable[num] = crc;
+    }
+
+    start(QThread::LowPriority);
+
+    return;
+}
+
+/**
+ * @brief SessionLog::~SessionLog
+ *   Destructor of the class SessionLog. The queued records are written before the thread ends.
+ */
+SessionLog::~SessionLog()
+{
+    {
+        QMutexLocker locker(&queueMutex);
+        stopping = true;
+        queueCond.wakeOne();
+    }
+
+    wait();
+
+    return;
+}
+
+/**
+ * @brief SessionLog::enqueue
+ *   Queues a record for the thread. If the disk can't keep up, the output is dropped
+ *   instead of blocking the caller; the number of dropped characters is logged.
+ * @param job
+ * @param kind
+ * @param text
+ */
+void SessionLog::enqueue(int job, char kind, const QString &text)
+{
+    QMutexLocker locker(&queueMutex);
+
+    if (kind != '$' && kind != '=' && queuedChars + text.size() > LOGQUEUEMAX) {
+        droppedChars+= text.size();
+        return;
+    }
+
+    Record record;
+
+    record.time = QDateTime::currentMSecsSinceEpoch();
+    record.job  = job;
+    record.kind = kind;
+    record.text = text;
+
+    queue << record;
+    queuedChars+= text.size();
+
+    queueCond.wakeOne();
+
+    return;
+}
+
+/**
+ * @brief SessionLog::command
+ * @param cmdLine
+ */
+void SessionLog::command(const QString &cmdLine)
+{
+    enqueue(0,'$',cmdLine);
+
+    return;
+}
+
+/**
+ * @brief SessionLog::output
+ * @param job
+ * @param channel  0 = standard output; 1 = standard error
+ * @param text
+ */
+void SessionLog::output(int job, int channel, const QString &text)
+{
+    if (text.isEmpty()) return;
+
+    enqueue(job,channel == 1 ? '2' : '1',text);
+
+    return;
+}
+
+/**
+ * @brief SessionLog::finished
+ * @param job
+ * @param exitCode
+ * @param info  command line and resource usage of the job
+ */
+void SessionLog::finished(int job, int exitCode, const QString &info)
+{
+    enqueue(job,'=',"exit "+QString::number(exitCode)+"  "+info);
+
+    return;
+}
+
+/**
+ * @brief SessionLog::run
+ *   Takes over the queued records, formats them and writes the buffer if it is full or
+ *   at least every LOGFLUSHTIME ms. The queue is taken over as a whole, so the
+ *   terminal window only waits for the mutex while a list is swapped.
+ */
+void SessionLog::run()
+{
+    QList<Record> records;
+    QElapsedTimer sinceWrite;
+    qint64 dropped;
+    bool   stop;
+
+    logFile.setFileName(fileName);
+
+    if (!logFile.open(QIODevice::WriteOnly|QIODevice::Append)) {
+      #ifdef DEBUG
+        cout << "Session log: could not open " << fileName.toStdString() << "\n";
+      #endif
+    }
+
+    sinceWrite.start();
+
+    for (;;) {
+        {
+            QMutexLocker locker(&queueMutex);
+            if (queue.isEmpty() && !stopping) {
+                queueCond.wait(&queueMutex,LOGFLUSHTIME);
+            }
+            records.swap(queue);
+            dropped      = droppedChars;
+            stop         = stopping;
+            queuedChars  = 0;
+            droppedChars = 0;
+        }
+
+        for (int idx = 0; idx < records.size(); idx++) {
+            format(records.at(idx));
+        }
+
+        if (dropped > 0) {
+            Record record;
+            record.time = QDateTime::currentMSecsSinceEpoch();
+            record.job  = 0;
+            record.kind = '!';
+            record.text = QString::number(dropped)+" characters of output dropped";
+            format(record);
+        }
+
+        // buffer full or records older than LOGFLUSHTIME? => write the buffer
+        if (buffer.size() >= LOGBUFFERSIZE || sinceWrite.elapsed() >= LOGFLUSHTIME || stop) {
+            writeBuffer();
+            sinceWrite.restart();
+        }
+
+        records.clear();
+
+        if (stop) break;
+    }
+
+    logFile.close();
+
+    return;
+}
+
+/**
+ * @brief SessionLog::format
+ *   Appends a record to the buffer; every line starts with the time, the job and the kind of
+ *   the record. Output not ending with a new line is continued by the next output of the same
+ *   job and channel; other records start a new line.
+ * @param record
+ */
+void SessionLog::format(const Record &record)
+{
+    QString text = stripEscapes(record.text);
+    QString prefix = QDateTime::fromMSecsSinceEpoch(record.time).toString("yyyy-MM-dd hh:mm:ss.zzz")+
+                     " ["+QString::number(record.job)+"] "+record.kind+" ";
+    int key = (record.kind == '1' || record.kind == '2') ? record.job*2 + (record.kind - '1') : -2;
+    int pos = 0;
+    int posNL;
+
+    // a line of another job or channel is open? => it's finished first
+    if (openKey >= 0 && openKey != key) {
+        buffer+= '\n';
+        openKey = -1;
+    }
+
+    while (pos < text.size()) {
+        if (openKey < 0) buffer+= prefix.toUtf8();
+        posNL = text.indexOf('\n',pos);
+        if (posNL < 0) {
+            buffer+= text.mid(pos).toUtf8();
+            openKey = (key >= 0) ? key : -1;
+            if (key < 0) buffer+= '\n';
+            break;
+        }
+        buffer+= text.mid(pos,posNL-pos+1).toUtf8();
+        openKey = -1;
+        pos = posNL + 1;
+    }
+
+    return;
+}
+
+/**
+ * @brief SessionLog::writeBuffer
+ *   Writes the buffer to the log file and starts a new segment if the file is too large.
+ */
+void SessionLog::writeBuffer()
+{
+    if (buffer.isEmpty() || !logFile.isOpen()) {
+        buffer.clear();
+        return;
+    }
+
+    logFile.write(buffer);
+    logFile.flush();
+
+    buffer.clear();
+
+    if (maxSize > 0 && logFile.size() >= maxSize) {
+        rotate();
+    }
+
+    return;
+}
+
+/**
+ * @brief SessionLog::rotate
+ *   Compresses the log file to the segment fn.1.gz; the older segments are renamed to
+ *   fn.2.gz ... fn.<segments>.gz and the oldest segment is removed. The log file is
+ *   compressed to a temporary file first, so the segments are only shifted if the
+ *   compression succeeded.
+ * @return
+ *   0 = new log file started
+ *   1 = could not compress the log file; the log file is continued
+ *   2 = could not open the new log file
+ */
+SessionLog::byte SessionLog::rotate()
+{
+    QString tmpName = fileName+".gz.tmp";
+
+    logFile.close();
+
+    // the log is continued in the same file rather than lost
+    if (segments >= 1 && compressFile(fileName,tmpName) != 0) {
+        QFile::remove(tmpName);
+        logFile.open(QIODevice::WriteOnly|QIODevice::Append);
+        return 1;
+    }
+
+    if (segments >= 1) {
+        QFile::remove(fileName+"."+QString::number(segments)+".gz");
+
+        for (int num = segments-1; num >= 1; num--) {
+            QFile::rename(fileName+"."+QString::number(num)+".gz",fileName+"."+QString::number(num+1)+".gz");
+        }
+
+        if (!QFile::rename(tmpName,fileName+".1.gz")) {
+            QFile::remove(tmpName);
+            logFile.open(QIODevice::WriteOnly|QIODevice::Append);
+            return 1;
+        }
+    }
+
+    QFile::remove(fileName);
+
+    if (!logFile.open(QIODevice::WriteOnly|QIODevice::Append)) return 2;
+
+    return 0;
+}
+
+/**
+ * @brief SessionLog::compressFile
+ *   Writes a file in the gzip format. qCompress() creates a zlib stream: a length of 4 bytes,
+ *   a header of 2 bytes, the deflate data and an Adler-32 checksum of 4 bytes. The deflate
+ *   data is framed with the gzip header and the CRC-32 and the size of the original data.
+ * @param src
+ * @param dst
+ * @return
+ *   0 = file compressed
+ *   1 = could not read the file
+ *   2 = could not write the compressed file
+ */
+SessionLog::byte SessionLog::compressFile(const QString &src, const QString &dst)
+{
+    QFile srcFile(src);
+    QFile dstFile(dst);
+
+    if (!srcFile.open(QIODevice::ReadOnly)) return 1;
+
+    QByteArray data = srcFile.readAll();
+
+    srcFile.close();
+
+    QByteArray zlib = qCompress(data,6);
+
+    if (zlib.size() < 10) return 1;
+
+    quint32 crc  = crc32(data);
+    quint32 size = (quint32)data.size();
+    quint32 time = (quint32)QFileInfo(src).lastModified().toSecsSinceEpoch();
+
+    QByteArray gzip;
+
+    gzip.reserve(zlib.size()+12);
+
+    // header: magic number, deflate, no flags, modification time, no extra flags, unknown OS
+    gzip+= (char)0x1f;
+    gzip+= (char)0x8b;
+    gzip+= (char)0x08;
+    gzip+= (char)0x00;
+    for (int shift = 0; shift < 32; shift+= 8) gzip+= (char)((time >> shift) & 0xff);
+    gzip+= (char)0x00;
+    gzip+= (char)0xff;
+
+    gzip+= zlib.mid(6,zlib.size()-10);
+
+    for (int shift = 0; shift < 32; shift+= 8) gzip+= (char)((crc >> shift) & 0xff);
+    for (int shift = 0; shift < 32; shift+= 8) gzip+= (char)((size >> shift) & 0xff);
+
+    if (!dstFile.open(QIODevice::WriteOnly|QIODevice::Truncate)) return 2;
+
+    if (dstFile.write(gzip) != gzip.size()) {
+        dstFile.close();
+        dstFile.remove();
+        return 2;
+    }
+
+    dstFile.close();
+
+    if (dstFile.error() != QFileDevice::NoError) {
+        dstFile.remove();
+        return 2;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief SessionLog::crc32
+ * @param data
+ * @return CRC-32 of the data
+ */
+quint32 SessionLog::crc32(const QByteArray &data)
+{
+    quint32 crc = 0xffffffffu;
+    const unsigned char *ptr = (const unsigned char *)data.constData();
+
+    for (qsizetype idx = 0; idx < data.size(); idx++) {
+        crc = crcTable[(crc ^ ptr[idx]) & 0xff] ^ (crc >> 8);
+    }
+
+    return crc ^ 0xffffffffu;
+}
+
+/**
+ * @brief SessionLog::stripEscapes
+ *   Removes the escape sequences of the terminal (colors, titles) from the output.
+ * @param text
+ * @return text without escape sequences
+ */
+QString SessionLog::stripEscapes(const QString &text)
+{
+    if (!text.contains(QChar(0x1b))) return text;
+
+    QString result;
+    int     pos = 0;
+
+    result.reserve(text.size());
+
+    while (pos < text.size()) {
+        if (text.at(pos).unicode() != 0x1b) {
+            result+= text.at(pos++);
+            continue;
+        }
+        pos++;
+        if (pos >= text.size()) break;
+        if (text.at(pos) == '[') {
+            // CSI: parameters up to a final byte between 0x40 and 0x7e
+            pos++;
+            while (pos < text.size() && (text.at(pos).unicode() < 0x40 || text.at(pos).unicode() > 0x7e)) pos++;
+            pos++;
+        } else if (text.at(pos) == ']') {
+            // OSC: up to BEL or ESC backslash
+            pos++;
+            while (pos < text.size() && text.at(pos).unicode() != 0x07 && text.at(pos).unicode() != 0x1b) pos++;
+            pos+= (pos < text.size() && text.at(pos).unicode() == 0x1b) ? 2 : 1;
+        } else if (text.at(pos) == '(' || text.at(pos) == ')') {
+            pos+= 2;  // character set
+        } else {
+            pos++;
+        }
+    }
+
+    return result;
+}
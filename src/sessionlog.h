@@ -0,0 +1,97 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef SESSIONLOG_H
+#define SESSIONLOG_H
+
+#include <iostream>
+#include <QByteArray>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QString>
+#include <QThread>
+#include <QWaitCondition>
+#include "main.h"
+
+/**
+ * @brief SessionLog
+ *   Log file of the commands entered in the terminal window and of their output. The
+ *   terminal window only queues the records; the thread of the class formats them with
+ *   timestamps and writes them in large blocks, so the GUI never waits for the disk.
+ *   If the log file exceeds its maximum size, it's compressed to a gzip segment and a
+ *   new log file is started; only the newest segments are kept.
+ */
+class SessionLog : public QThread
+{
+    Q_OBJECT
+
+    typedef unsigned char byte;
+
+    #define LOGBUFFERSIZE 65536     // formatted records are written if the buffer exceeds this size
+    #define LOGFLUSHTIME  1000      // maximum time in ms formatted records are kept in the buffer
+    #define LOGQUEUEMAX   67108864  // maximum number of queued characters; further output is dropped
+
+    // structure of a record queued by the terminal window
+    struct Record {
+        qint64  time;     // ms since the epoch
+        int     job;      // number of the job; 0 = entered command
+        char    kind;     // '$' = command, '1' = standard output, '2' = standard error, '=' = end of the job
+        QString text;
+    };
+
+    QString fileName;
+    qint64  maxSize;        // maximum size of the log file in bytes
+    int     segments;       // number of compressed segments kept
+
+    QMutex         queueMutex;   // protects queue, queuedChars, droppedChars and stopping
+    QWaitCondition queueCond;
+    QList<Record>  queue;
+    qint64 queuedChars  = 0;
+    qint64 droppedChars = 0;
+    bool   stopping     = false;
+
+    // used in the thread of the class only
+    QFile      logFile;
+    QByteArray buffer;            // formatted records not yet written
+    int        openKey = -1;      // job and channel of an output line not yet finished; -1 = none
+    quint32    crcTable[256];
+
+    void run() override;
+    void enqueue(int job, char kind, const QString &text);
+    void format(const Record &record);
+    void writeBuffer();
+    byte rotate();
+    byte compressFile(const QString &src, const QString &dst);
+    quint32 crc32(const QByteArray &data);
+    static QString stripEscapes(const QString &text);
+
+  public:
+    SessionLog(const QString &fn, qint64 max, int segs, QObject *parent = nullptr);
+    ~SessionLog();
+
+    void command(const QString &cmdLine);                     // logs an entered command
+    void output(int job, int channel, const QString &text);   // logs output of a job
+    void finished(int job, int exitCode, const QString &info);  // logs the end of a job
+};
+
+#endif // SESSIONLOG_H
@@ -0,0 +1,429 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include "shellsession.h"
+
+using namespace std;
+
+/**
+ * @brief ShellSession::ShellSession
+ *   Constructor of the class ShellSession. The shell is started with the first command.
+ * @param parent
+ */
+ShellSession::ShellSession(QObject *parent) : QObject(parent)
+{
+    decoder = new OutputDecoder(OutputDecoder::UTF8);
+
+    // the token prevents the output of a command from being taken as sentinel
+    marker = "\036CMDLIB" + QByteArray::number(QCoreApplication::applicationPid()) + "-"
+                          + QByteArray::number(QRandomGenerator::global()->generate()) + " ";
+
+    wallTimer = new QTimer(this);
+    wallTimer->setSingleShot(true);
+
+    connect(wallTimer,SIGNAL(timeout()),this,SLOT(commandTimedOut()));
+
+    return;
+}
+
+/**
+ * @brief ShellSession::~ShellSession
+ *   Destructor of the class ShellSession. The shell is killed.
+ */
+ShellSession::~ShellSession()
+{
+    closeInput();
+
+    if (process != nullptr) {
+        process->disconnect(this);
+        delete process;
+    }
+
+  #ifdef Q_OS_UNIX
+    if (!fifoName.isEmpty()) ::unlink(fifoName.constData());
+  #endif
+
+    delete decoder;
+
+    return;
+}
+
+/**
+ * @brief ShellSession::setLimits
+ *   Sets the limits of the shell. The running shell keeps its limits, so the state of
+ *   the session isn't lost; they apply from the next start of the shell.
+ * @param lim
+ */
+void ShellSession::setLimits(const LimitedProcess::Limits &lim)
+{
+    limits = lim;
+
+    return;
+}
+
+/**
+ * @brief ShellSession::appliesLimits
+ *   Checks whether the commands are executed with the limits of CPU time, address space,
+ *   open files and the cgroup. The timeout is passed to execute() per command.
+ * @param lim
+ * @return false = the shell was started with other limits
+ */
+bool ShellSession::appliesLimits(const LimitedProcess::Limits &lim)
+{
+    const LimitedProcess::Limits &current = (process != nullptr) ? shellLimits : limits;
+
+    return lim.cpu == current.cpu && lim.memory == current.memory && lim.files == current.files && lim.cgroup == current.cgroup;
+}
+
+/**
+ * @brief ShellSession::startShell
+ *   Starts the shell without the start files of the user. Aliases are expanded
+ *   although the shell isn't interactive. The shell leads a new process group and
+ *   traps SIGINT and SIGTERM, so signalCommand() terminates the command only; the
+ *   commands get the default handling of the signals back.
+ * @param workDir  initial working directory of the shell
+ * @return false = the shell couldn't be started
+ */
+bool ShellSession::startShell(const QString &workDir)
+{
+  #ifdef Q_OS_UNIX
+    // the FIFO of the standard input is created once per session
+    if (fifoName.isEmpty()) {
+        QByteArray name = QFile::encodeName(QDir::tempPath()) + "/cmdlib-" + marker.mid(7).trimmed() + ".stdin";
+        if (::mkfifo(name.constData(),0600) == 0) fifoName = name;
+    }
+  #endif
+
+    process = new LimitedProcess(this);
+
+    // the error messages of the shell are in order with the output of the commands
+    process->setProcessChannelMode(QProcess::MergedChannels);
+    process->setWorkingDirectory(workDir);
+    process->setProcessGroup(true);
+
+    // the limits except for the timeout are inherited by the commands; the timeout applies per command
+    shellLimits = limits;
+    shellLimits.timeout = 0;
+    process->setLimits(shellLimits);
+
+    connect(process,SIGNAL(readyReadStandardOutput()),this,SLOT(readOutput()));
+    connect(process,SIGNAL(finished(int,QProcess::ExitStatus)),this,SLOT(shellFinished(int,QProcess::ExitStatus)));
+
+    process->start("bash",QStringList() << "--noprofile" << "--norc");
+
+    if (!process->waitForStarted()) {
+        process->disconnect(this);
+        process->deleteLater();
+        process = nullptr;
+        return false;
+    }
+
+    process->write("shopt -s expand_aliases\ntrap : INT TERM\n");
+
+  #ifdef DEBUG
+    cout << "Shell started.\n";
+  #endif
+
+    return true;
+}
+
+/**
+ * @brief ShellSession::execute
+ *   Writes a command line to the shell. The command line is executed by eval, so a syntax
+ *   error doesn't break the sentinel. The standard input of the command is the FIFO of
+ *   the session, otherwise the command would read the following commands of the session.
+ *   Without a FIFO the standard input is /dev/null.
+ * @param cmdLine
+ * @param workDir  working directory if the shell has to be started
+ * @param timeout  wall clock time of the command in seconds; 0 = unlimited
+ * @return false = shell busy or not available
+ */
+bool ShellSession::execute(const QString &cmdLine, const QString &workDir, int timeout)
+{
+    QByteArray script;
+    QByteArray quoted = cmdLine.toUtf8();
+    QByteArray stdinFile;
+
+    if (busy) return false;
+
+    if (process == nullptr && !startShell(workDir)) return false;
+
+    quoted.replace("'","'\\''");
+
+    openInput();
+
+    stdinFile = (inputFd >= 0) ? fifoName : QByteArray("/dev/null");
+    stdinFile.replace("'","'\\''");
+
+    script = "eval '" + quoted + "' <'" + stdinFile + "' 2>&1; "
+             "printf '%s%d %s\\036' '" + marker + "' $? \"$PWD\"\n";
+
+    busy     = true;
+    timedOut = false;
+
+    process->write(script);
+
+    if (timeout > 0) wallTimer->start(timeout*1000);
+
+    return true;
+}
+
+/**
+ * @brief ShellSession::signalCommand
+ *   Sends a signal to the process group of the shell. The command and its children
+ *   terminate; the shell traps the signal and prints the sentinel.
+ * @param sig
+ */
+void ShellSession::signalCommand(int sig)
+{
+    if (process == nullptr || !busy) return;
+
+  #ifdef Q_OS_UNIX
+    if (process->processId() > 0) ::kill(-(pid_t)process->processId(),sig);
+  #else
+    Q_UNUSED(sig);
+  #endif
+
+    return;
+}
+
+/**
+ * @brief ShellSession::commandTimedOut
+ *   Is called if the command exceeded its wall clock time. The command gets SIGTERM,
+ *   which the shell traps. If the command is still running after KILLDELAY, the process
+ *   group is killed; the session ends and the next command starts a new shell.
+ */
+void ShellSession::commandTimedOut()
+{
+    if (process == nullptr || !busy) return;
+
+  #ifdef Q_OS_UNIX
+    if (!timedOut) {
+        timedOut = true;
+        emit timedOut_signal();
+        signalCommand(SIGTERM);
+        wallTimer->start(KILLDELAY);
+    } else {
+        signalCommand(SIGKILL);
+    }
+  #endif
+
+    return;
+}
+
+/**
+ * @brief ShellSession::openInput
+ *   Opens the write end of the FIFO for the next command. The FIFO is opened for reading
+ *   and writing, so neither the shell nor the window waits for the other end.
+ */
+void ShellSession::openInput()
+{
+    closeInput();
+
+  #ifdef Q_OS_UNIX
+    if (fifoName.isEmpty()) return;
+
+    inputFd = ::open(fifoName.constData(),O_RDWR|O_NONBLOCK|O_CLOEXEC);
+
+    if (inputFd >= 0) {
+        inputNotifier = new QSocketNotifier(inputFd,QSocketNotifier::Write,this);
+        inputNotifier->setEnabled(false);
+        connect(inputNotifier,SIGNAL(activated(QSocketDescriptor,QSocketNotifier::Type)),this,SLOT(writeQueued()));
+    }
+  #endif
+
+    return;
+}
+
+/**
+ * @brief ShellSession::closeInput
+ *   Closes the write end of the FIFO; the command reads the end of its input. Input
+ *   not yet read is discarded with the FIFO's buffer.
+ */
+void ShellSession::closeInput()
+{
+    delete inputNotifier;
+    inputNotifier = nullptr;
+
+  #ifdef Q_OS_UNIX
+    if (inputFd >= 0) ::close(inputFd);
+  #endif
+
+    inputFd  = -1;
+    inputEof = false;
+    input.clear();
+
+    return;
+}
+
+/**
+ * @brief ShellSession::writeInput
+ *   Queues input of the running command and writes as much as the FIFO takes.
+ * @param data
+ * @return false = no command running or its input ended
+ */
+bool ShellSession::writeInput(const QByteArray &data)
+{
+    if (!busy || inputFd < 0 || inputEof) return false;
+
+    input+= data;
+
+    writeQueued();
+
+    return true;
+}
+
+/**
+ * @brief ShellSession::endInput
+ *   Closes the input of the running command as soon as the queued input is written.
+ */
+void ShellSession::endInput()
+{
+    if (inputFd < 0) return;
+
+    inputEof = true;
+
+    writeQueued();
+
+    return;
+}
+
+/**
+ * @brief ShellSession::writeQueued
+ *   Writes the queued input to the FIFO. If the FIFO is full, the rest is written when
+ *   the notifier reports the FIFO writable again.
+ */
+void ShellSession::writeQueued()
+{
+  #ifdef Q_OS_UNIX
+    ssize_t size = 0;
+    int     written = 0;
+
+    if (inputFd < 0) return;
+
+    while (written < input.size()) {
+        size = ::write(inputFd,input.constData()+written,input.size()-written);
+        if (size < 0 && errno == EINTR) continue;
+        if (size <= 0) break;
+        written+= (int)size;
+    }
+
+    input.remove(0,written);
+
+    // FIFO full? => the notifier continues; other errors discard the input
+    if (size < 0 && errno != EAGAIN && errno != EWOULDBLOCK) input.clear();
+
+    inputNotifier->setEnabled(!input.isEmpty());
+
+    if (input.isEmpty() && inputEof) closeInput();
+  #endif
+
+    return;
+}
+
+/**
+ * @brief ShellSession::readOutput
+ *   Passes the output of the shell on until the sentinel. The sentinel finishes the command.
+ */
+void ShellSession::readOutput()
+{
+    int pos;
+    int end;
+    int keep;
+    QByteArray fields;
+
+    buffer+= process->readAllStandardOutput();
+
+    while (!buffer.isEmpty()) {
+        pos = buffer.indexOf(marker);
+
+        if (pos < 0) {
+            // the end of the buffer may be the beginning of the sentinel
+            keep = buffer.lastIndexOf('\036');
+            if (keep < 0 || buffer.size() - keep >= marker.size()) keep = buffer.size();
+            if (keep > 0) {
+                emit output_signal(decoder->decode(buffer.left(keep)));
+                buffer.remove(0,keep);
+            }
+            return;
+        }
+
+        if (pos > 0) {
+            emit output_signal(decoder->decode(buffer.left(pos)));
+            buffer.remove(0,pos);
+            pos = 0;
+        }
+
+        // sentinel complete?
+        end = buffer.indexOf('\036',marker.size());
+        if (end < 0) return;
+
+        fields = buffer.mid(marker.size(),end-marker.size());
+        buffer.remove(0,end+1);
+
+        pos  = fields.indexOf(' ');
+        busy = false;
+
+        wallTimer->stop();
+
+        closeInput();
+
+        emit done_signal(fields.left(pos).toInt(),QString::fromLocal8Bit(fields.mid(pos+1)));
+    }
+
+    return;
+}
+
+/**
+ * @brief ShellSession::shellFinished
+ *   Is called if the shell terminated, e.g. by the command exit. The next command starts
+ *   a new shell.
+ * @param exitCode
+ * @param exitStatus
+ */
+void ShellSession::shellFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    Q_UNUSED(exitStatus);
+
+    // output of the last command
+    buffer+= process->readAllStandardOutput();
+    if (!buffer.isEmpty()) {
+        emit output_signal(decoder->decode(buffer));
+        buffer.clear();
+    }
+
+    decoder->reset();
+
+    closeInput();
+
+    wallTimer->stop();
+
+    process->disconnect(this);
+    process->deleteLater();
+    process = nullptr;
+
+  #ifdef DEBUG
+    cout << "Shell finished.\n";
+  #endif
+
+    if (busy) {
+        busy = false;
+        emit done_signal(exitCode,QString());
+    }
+
+    return;
+}
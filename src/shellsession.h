@@ -0,0 +1,109 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef SHELLSESSION_H
+#define SHELLSESSION_H
+
+#include <csignal>
+#include <iostream>
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QObject>
+#include <QProcess>
+#include <QRandomGenerator>
+#include <QSocketNotifier>
+#include <QString>
+#include <QTimer>
+#include "limitedprocess.h"
+#include "main.h"
+#include "outputdecoder.h"
+
+#ifdef Q_OS_UNIX
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/stat.h>
+#endif
+
+/**
+ * @brief ShellSession
+ *   Persistent bash process executing the commands of a terminal window. The commands are
+ *   written to the standard input of the shell, so the environment, aliases, functions and
+ *   the working directory are kept between the commands. After a command the shell prints
+ *   a sentinel with the exit status and the working directory, which separates the output
+ *   of the commands. The standard input of a command is a FIFO the input of the terminal
+ *   window is written to. The shell leads its own process group, so signals reach the
+ *   running command; the shell itself traps them and keeps the session. The commands
+ *   inherit the limits of CPU time, address space and open files of the shell; the wall
+ *   clock time is watched per command.
+ */
+class ShellSession : public QObject
+{
+    Q_OBJECT
+
+    #define KILLDELAY 2000  // milliseconds from SIGTERM to SIGKILL after the timeout of a command
+
+    LimitedProcess *process = nullptr;
+    OutputDecoder  *decoder;
+
+    QByteArray marker;  // start of the sentinel: record separator and token of the session
+    QByteArray buffer;  // output not yet passed on; may contain the beginning of a sentinel
+
+    QByteArray fifoName;   // FIFO of the standard input of the commands; empty = /dev/null
+    int        inputFd = -1;                  // write end of the FIFO while a command runs
+    QSocketNotifier *inputNotifier = nullptr;  // reports the FIFO writable again
+    QByteArray input;      // input not yet written to the FIFO
+    bool       inputEof = false;  // the FIFO is closed after the input is written
+
+    bool busy = false;  // a command is executed
+
+    LimitedProcess::Limits limits;       // limits of the shell started next
+    LimitedProcess::Limits shellLimits;  // limits of the running shell
+    QTimer *wallTimer;                   // watches the wall clock time of the command
+    bool    timedOut = false;            // the command was terminated after its timeout
+
+    bool startShell(const QString &workDir);
+    void openInput();
+    void closeInput();
+
+  private slots:
+    void readOutput();
+    void writeQueued();
+    void shellFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void commandTimedOut();
+
+  public:
+    explicit ShellSession(QObject *parent = nullptr);
+    ~ShellSession();
+
+    void setLimits(const LimitedProcess::Limits &lim);  // limits of the shell; apply from the next start of the shell
+    bool appliesLimits(const LimitedProcess::Limits &lim);  // the commands run with these limits except for the timeout
+    bool execute(const QString &cmdLine, const QString &workDir, int timeout = 0);  // executes a command line in the shell
+    void signalCommand(int sig);          // sends a signal to the running command; e.g. SIGINT
+    bool writeInput(const QByteArray &data);  // queues input of the running command; false = no input
+    void endInput();                      // ends the input of the running command after the queued input
+    bool isBusy() { return busy; }
+
+  signals:
+    void output_signal(QString);
+    void done_signal(int exitCode, QString pwd);
+    void timedOut_signal();
+};
+
+#endif // SHELLSESSION_H
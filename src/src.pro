@@ -5,32 +5,74 @@ QT       = core gui
 QT      += sql
 
 greaterThan(QT_MAJOR_VERSION,4): QT+= widgets
-greaterThan(QT_MAJOR_VERSION,5): QT+= core5compat
+
+# forkpty() of the pseudo terminal backend
+unix: LIBS+= -lutil
 
 TRANSLATIONS = ../final/loc/cmdlib_de.ts
 
 HEADERS = \
     adddialog.h \
+    ansiparser.h \
+    batchdialog.h \
+    batchrunner.h \
+    categorymodel.h \
     cfgaccess.h \
+    cmdhistory.h \
+    cmdindex.h \
+    cmdprofile.h \
+    commandfilter.h \
+    commandmodel.h \
     dbaccess.h \
     dbconnect.h \
     dbsqlite.h \
     dbtext.h \
+    findbar.h \
     introwindow.h \
+    limitedprocess.h \
+    linediff.h \
     main.h \
     mainwindow.h \
+    outputdecoder.h \
+    pathindex.h \
+    ptyprocess.h \
+    resultcache.h \
+    scrollbackindex.h \
+    sessionlog.h \
     settingsdialog.h \
-    terminalwindow.h
+    shellsession.h \
+    terminalwindow.h \
+    trigramindex.h
 
 SOURCES = \
     adddialog.cpp \
+    ansiparser.cpp \
+    batchdialog.cpp \
+    batchrunner.cpp \
+    categorymodel.cpp \
     cfgaccess.cpp \
+    cmdhistory.cpp \
+    cmdindex.cpp \
+    cmdprofile.cpp \
+    commandfilter.cpp \
+    commandmodel.cpp \
     dbaccess.cpp \
     dbconnect.cpp \
     dbsqlite.cpp \
     dbtext.cpp \
+    findbar.cpp \
     introwindow.cpp \
+    limitedprocess.cpp \
+    linediff.cpp \
     main.cpp \
     mainwindow.cpp \
+    outputdecoder.cpp \
+    pathindex.cpp \
+    ptyprocess.cpp \
+    resultcache.cpp \
+    scrollbackindex.cpp \
+    sessionlog.cpp \
     settingsdialog.cpp \
-    terminalwindow.cpp
+    shellsession.cpp \
+    terminalwindow.cpp \
+    trigramindex.cpp
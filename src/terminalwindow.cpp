@@ -28,7 +28,7 @@ namespace lv {  // namespace for loop variables
  *   Constructor of the class TerminalWindow.
  * @param parent
  */
-TerminalWindow::TerminalWindow(QWidget *parent) : QTextEdit(parent)
+TerminalWindow::TerminalWindow(QWidget *parent) : QPlainTextEdit(parent)
 {
     QTextCharFormat *charFormat = new QTextCharFormat();
 
@@ -39,38 +39,122 @@ TerminalWindow::TerminalWindow(QWidget *parent) : QTextEdit(parent)
 
     charFormat->setFont(*termFont);
 
-    currCursor = textCursor();  // textCursor() only returns a copy of QTextEdit's text cursor
+    plainFormat = *charFormat;
+
+    // The plain text layout lays out and paints only the visible blocks and scrolls by
+    // blocks; the default font keeps the height of the blocks uniform.
+    document()->setDefaultFont(*termFont);
+
+    currCursor = textCursor();  // textCursor() only returns a copy of QPlainTextEdit's text cursor
 
     currCursor.setCharFormat(*charFormat);
     currCursor.insertText("cmd$ ");
 
     // The following setTextCursor() call is needed only, if there are changes to the text cursor attributes.
-    // The copy of QTextEdit's text cursor works on the same document as the QTextEdit's text cursor.
+    // The copy of QPlainTextEdit's text cursor works on the same document as the QPlainTextEdit's text cursor.
     setTextCursor(currCursor);
 
     cmdLineStart = currCursor.position();
     cmdLineEnd   = cmdLineStart;
     cmdEntered   = new QString;
-    process      = new QProcess(this);
     homeDir      = QDir::homePath()/*"c:/Users/R.Otto"*/;
 
     homeDir.replace(0,1,homeDir.at(0).toUpper());
 
-    workDir = new QDir(homeDir);
+    workDir = new QDir(homeDir);  // working directory of the processes
 
-    process->setWorkingDirectory(homeDir);  // set the working directory
+    // The undo stack would keep every inserted output and removed line of the scrollback.
+    document()->setUndoRedoEnabled(false);
+
+    // The process output is collected and inserted into the document at most once per frame,
+    // so the document is laid out once for all output read during the interval.
+    flushTimer = new QTimer(this);
+    flushTimer->setSingleShot(true);
+    flushTimer->setInterval(FLUSHINTERVAL);
 
     // Get the drive of the home directory under Windows;
     // under Linux the drive is the root directory.
     wrkDrive = homeDir.at(0);
 
+    // under Windows the console output is encoded with the code page 850
+    encoding = (wrkDrive != '/') ? OutputDecoder::IBM850 : OutputDecoder::UTF8;
+
     connect(this,SIGNAL(commandInt_signal(TerminalWindow::BuiltInCmds,QStringList*)),this,SLOT(commandInternal(TerminalWindow::BuiltInCmds,QStringList*)));
     connect(this,SIGNAL(commandExt_signal(QStringList*)),this,SLOT(commandExternal(QStringList*)));
 
-    connect(process,SIGNAL(started()),this,SLOT(commandStarted()));
-    connect(process,SIGNAL(errorOccurred(QProcess::ProcessError)),this,SLOT(commandError(QProcess::ProcessError)));
-    connect(process,SIGNAL(channelReadyRead(int)),this,SLOT(commandReadyRead(int)));
-    connect(process,SIGNAL(finished(int,QProcess::ExitStatus)),this,SLOT(commandFinished(int,QProcess::ExitStatus)));
+    // The memory usage of the running jobs is sampled, because it isn't available after a process terminated.
+    sampleTimer = new QTimer(this);
+    sampleTimer->setInterval(SAMPLEINTERVAL);
+
+    connect(flushTimer,SIGNAL(timeout()),this,SLOT(flushOutput()));
+    connect(sampleTimer,SIGNAL(timeout()),this,SLOT(sampleJobs()));
+
+    // The executables of PATH are indexed in the background for the completion with Tab.
+    pathIndex = new PathIndex(this);
+    pathIndex->build();
+
+    // Ctrl-F searches the scrollback; the index is updated with every inserted output.
+    scrollIndex = new ScrollbackIndex();
+    findBar     = new FindBar(this);
+
+    countTimer = new QTimer(this);
+    countTimer->setSingleShot(true);
+    countTimer->setInterval(COUNTDELAY);
+
+    connect(findBar,SIGNAL(find_signal(QString)),this,SLOT(findChanged(QString)));
+    connect(findBar,SIGNAL(findNext_signal()),this,SLOT(findNext()));
+    connect(findBar,SIGNAL(findPrevious_signal()),this,SLOT(findPrevious()));
+    connect(findBar,SIGNAL(closed_signal()),this,SLOT(findClosed()));
+    connect(countTimer,SIGNAL(timeout()),this,SLOT(countHits()));
+    connect(verticalScrollBar(),SIGNAL(valueChanged(int)),this,SLOT(highlightHits()));
+
+    // watch executes a command repeatedly; the next run starts an interval after the last run
+    watchTimer = new QTimer(this);
+    watchTimer->setSingleShot(true);
+
+    connect(watchTimer,SIGNAL(timeout()),this,SLOT(runWatch()));
+
+    // All changes of the document are batched by beginEdit() and endEdit(); the scrollbar
+    // is moved to the end at most once per turn of the event loop.
+    scrollTimer = new QTimer(this);
+    scrollTimer->setSingleShot(true);
+    scrollTimer->setInterval(0);
+
+    connect(scrollTimer,SIGNAL(timeout()),this,SLOT(scrollToEndNow()));
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::~TerminalWindow
+ *   Destructor of the class TerminalWindow. The running processes are killed.
+ */
+TerminalWindow::~TerminalWindow()
+{
+    for (int idx = 0; idx < jobs.size(); idx++) {
+        Job *job = jobs.at(idx);
+        for (int num = 0; num < job->stages.size(); num++) {
+            job->stages.at(num)->disconnect(this);  // no slots are called while the window is destroyed
+            delete job->stages.at(num);             // kills a running process
+        }
+        if (job->pty != nullptr) {
+            job->pty->disconnect(this);
+            delete job->pty;
+        }
+        delete job->spool;
+        delete job->ansi;
+        delete job->decoders[QProcess::StandardOutput];
+        delete job->decoders[QProcess::StandardError];
+        delete job;
+    }
+
+    jobs.clear();
+
+    if (watchProcess != nullptr) watchProcess->disconnect(this);
+
+    delete lastSpool;  // removes the temporary file
+    delete scrollIndex;
+    delete sessionLog;  // writes the queued records
 
     return;
 }
@@ -90,24 +174,114 @@ void TerminalWindow::keyPressEvent(QKeyEvent *event)
     //cout << posCmdLine << "  ";
     //cout.flush();
 
+    // Reverse search active? => the key is processed as usual only if the search is finished
+    if (searchMode && !searchKeyPressed(event)) return;
+
+    // Foreground job running in a pseudo terminal? => the keys are input of the job;
+    // the terminal echoes them. Ctrl-C with selected text copies the text.
+    if (fgJob != nullptr && fgJob->pty != nullptr && !fgJob->finished &&
+        !(event->matches(QKeySequence::Copy) && textCursor().hasSelection())) {
+        forwardKey(event);
+        return;
+    }
+
+    // Ctrl-F opens the search in the scrollback
+    if (event->matches(QKeySequence::Find)) {
+        placeFindBar();
+        findBar->open();
+        return;
+    }
+
+    // Command watched? => Ctrl-C or Escape stops the watch; other keys are ignored
+    if (watching) {
+        if (event->key() == Qt::Key_Escape ||
+            (event->key() == Qt::Key_C && (event->modifiers() & Qt::ControlModifier) && !textCursor().hasSelection())) {
+            stopWatch();
+        }
+        return;
+    }
+
     currCursor  = textCursor();
     cmdLineCurr = currCursor.position();
     cmdBuiltIn  = NONE;
 
+    // Ctrl-C interrupts the foreground job; with selected text Ctrl-C copies the text
+    if (event->key() == Qt::Key_C && (event->modifiers() & Qt::ControlModifier) &&
+        fgJob != nullptr && !currCursor.hasSelection()) {
+        interruptJob(fgJob);
+        return;
+    }
+
+    // Ctrl-D passes on the entered line and ends the input of the foreground job
+    if (event->key() == Qt::Key_D && (event->modifiers() & Qt::ControlModifier) &&
+        fgJob != nullptr && (fgJob->stdinProcess != nullptr || fgJob->session != nullptr)) {
+        sendInput(fgJob,getCommandLine());
+        if (fgJob->session != nullptr) {
+            fgJob->session->endInput();
+        } else {
+            fgJob->inputEof = true;
+            writeInput(fgJob);
+        }
+        currCursor.movePosition(QTextCursor::End);
+        currCursor.insertText("\n");
+        setTextCursor(currCursor);
+        cmdLineStart = currCursor.position();
+        cmdLineEnd   = cmdLineStart;
+        return;
+    }
+
+    // Ctrl-R starts the reverse search in the history
+    if (event->key() == Qt::Key_R && (event->modifiers() & Qt::ControlModifier) &&
+        fgJob == nullptr && history != nullptr) {
+        searchMode = true;
+        searchPos  = -1;
+        searchText.clear();
+        searchLine = getCommandLine();
+        searchHistory(history->size());
+        return;
+    }
+
+    // the changes of the key and of the command executed are laid out once
+    beginEdit();
+
     switch (event->key()) {
         case Qt::Key_Backspace:
         case Qt::Key_Left:
-            if (cmdLineCurr > cmdLineStart) QTextEdit::keyPressEvent(event);
+            if (cmdLineCurr > cmdLineStart) QPlainTextEdit::keyPressEvent(event);
             break;
         case Qt::Key_Up:
+            if (fgJob == nullptr && history != nullptr) historyUp();
+            break;
+        case Qt::Key_Down:
+            if (fgJob == nullptr && history != nullptr) historyDown();
             break;
         case Qt::Key_Home:
             currCursor.setPosition(cmdLineStart);
             setTextCursor(currCursor);
             break;
+        case Qt::Key_Tab:
+            if (fgJob == nullptr && cmdLineCurr >= cmdLineStart) completeLine();
+            break;
         case Qt::Key_Return:
+            histPos = -1;
+
+            // Shift+Return executes a cacheable command again instead of replaying its cached output
+            refreshCache = (event->modifiers() & Qt::ShiftModifier) != 0;
+
+            // the line is always executed at its end
+            currCursor.movePosition(QTextCursor::End);
+            setTextCursor(currCursor);
+
             // call of the basis class implementation due to finish the line with the entered return
-            QTextEdit::keyPressEvent(event);
+            QPlainTextEdit::keyPressEvent(event);
+
+            // A command is running in the foreground? => the entered line is its input
+            if (fgJob != nullptr) {
+                sendInput(fgJob,getCommandLine().replace(QChar(0x2029),'\n'));
+                cmdLineStart = document()->characterCount() - 1;
+                cmdLineEnd   = cmdLineStart;
+                break;
+            }
 
             cmdLineEnd = document()->characterCount() - 1;  // position of the last character = size of the document - 1
 
@@ -122,6 +296,10 @@ void TerminalWindow::keyPressEvent(QKeyEvent *event)
                 // send main window the entered command
                 emit commandEntered_signal(cmdEntered);
 
+                if (sessionLog != nullptr) sessionLog->command(*cmdEntered);
+
+                lineEntered = *cmdEntered;
+
                 // The tilde (~) for the home directory used in the pathname?
                 if (cmdEntered->contains('~')) {
                     int pos = cmdEntered->indexOf('~');
@@ -132,9 +310,17 @@ void TerminalWindow::keyPressEvent(QKeyEvent *event)
                 cmdParts = getCommandParts(cmdEntered);
 
                 // Built in command entered?
-                if (cmdParts->at(0) == "cd")    { cmdBuiltIn = CD; }
+                if (cmdParts->at(0) == "cd" && shell == nullptr) { cmdBuiltIn = CD; }
                 if (cmdParts->at(0) == "clear") { cmdBuiltIn = CLEAR; }
                 if (cmdParts->at(0) == "exit")  { cmdBuiltIn = EXIT; }
+                if (cmdParts->at(0) == "jobs")  { cmdBuiltIn = JOBS; }
+                if (cmdParts->at(0) == "fg")    { cmdBuiltIn = FG; }
+                // only kill with a job specification (%1) is built in; process ids are passed to the kill command
+                if (cmdParts->at(0) == "kill" && (cmdParts->size() == 1 || (cmdParts->size() == 2 && cmdParts->at(1).startsWith('%')))) {
+                    cmdBuiltIn = KILL;
+                }
+                if (cmdParts->at(0) == "watch") { cmdBuiltIn = WATCH; }
+                if (cmdParts->at(0) == "save")  { cmdBuiltIn = SAVE; }
 
                 if (cmdBuiltIn != NONE) {
                     emit commandInt_signal(cmdBuiltIn,cmdParts);
@@ -153,10 +339,14 @@ void TerminalWindow::keyPressEvent(QKeyEvent *event)
             }
             break;
         default:
-            QTextEdit::keyPressEvent(event);
+            // an edited line is the new prefix of Up/Down
+            if (!event->text().isEmpty()) histPos = -1;
+            QPlainTextEdit::keyPressEvent(event);
             break;
     }
 
+    endEdit();
+
     return;
 }
 
@@ -167,31 +357,36 @@ void TerminalWindow::keyPressEvent(QKeyEvent *event)
  */
 void TerminalWindow::setCommandSelected(QString *cmd)
 {
-    currCursor = textCursor();
-    cmdLineEnd = document()->characterCount() - 1;  // position of the last character = size of the document - 1
-    currCursor.setPosition(cmdLineEnd);
+    // Command watched? => the output of the watched command isn't replaced
+    if (watching) return;
 
-    // Is there a command still next to the prompt?
-    while (cmdLineEnd > cmdLineStart) {
-        currCursor.deletePreviousChar();
-        cmdLineEnd--;
-    }
+    beginEdit();
+
+    // a command still next to the prompt is replaced as one range
+    setCommandLine(*cmd);
+    cmdLineEnd = cmdLineStart;
+
+    endEdit();
 
-    currCursor.insertText(*cmd);
-    setTextCursor(currCursor);
     return;
 }
 
 /**
  * @brief TerminalWindow::getCommandParts
  *   Identifies command and arguments from the entered command line in the terminal window.
+ *   Parts in double or single quotes may contain spaces. The operators | < > >> 2> 2>> 2>&1
+ *   & and && are separate parts, if they aren't quoted. cmdOperators marks these parts,
+ *   so a quoted part looking like an operator remains an argument.
  * @param cmd  entered command line
- * @return list containing the command and arguments
+ * @return list containing the command, arguments and operators
  */
 QStringList *TerminalWindow::getCommandParts(QString *cmd)
 {
     QChar       ch;
-    QString     part;  // defines a null string
+    QChar       quote;           // quote character of a quoted part; null = not quoted
+    QString     part;            // defines a null string
+    QString     op;
+    bool        quoted = false;  // part contains quotes => an empty part is a part too
     QStringList *parts = new QStringList;  // list for the command line parts
 
   #ifdef DEBUG
@@ -199,18 +394,138 @@ QStringList *TerminalWindow::getCommandParts(QString *cmd)
     cout.flush();
   #endif
 
+    cmdOperators.clear();
+
     for (lv::pos = 0; lv::pos < cmd->size(); lv::pos++) {
         ch = cmd->at(lv::pos);
-        if (ch != ' ') part.append(ch);
-        if ((ch == ' ') || (lv::pos >= (cmd->size()-1))) {
-            *parts << part;
-            part.clear();
+
+        if (!quote.isNull()) {
+            // inside of quotes all characters belong to the part
+            if (ch == quote) quote = QChar();
+            else part.append(ch);
+            continue;
+        }
+
+        switch (ch.unicode()) {
+            case '"':
+            case '\'':
+                quote  = ch;
+                quoted = true;
+                break;
+            case ' ':
+            case '\t':
+            case '|':
+            case '<':
+            case '&':
+            case '>':
+                // the characters 2> redirect the standard error channel
+                if (ch == '>' && part == "2" && !quoted) {
+                    op = "2>";
+                    part.clear();
+                } else {
+                    op = ch;
+                }
+                if (!part.isEmpty() || quoted) {
+                    *parts << part;
+                    cmdOperators << false;
+                    part.clear();
+                    quoted = false;
+                }
+                if (ch == '&' && lv::pos+1 < cmd->size() && cmd->at(lv::pos+1) == '&') {
+                    op+= '&';
+                    lv::pos++;
+                }
+                if (ch == '>') {
+                    if (lv::pos+1 < cmd->size() && cmd->at(lv::pos+1) == '>') {
+                        op+= '>';
+                        lv::pos++;
+                    } else if (op == "2>" && cmd->mid(lv::pos+1,2) == "&1") {
+                        op+= "&1";
+                        lv::pos+= 2;
+                    }
+                }
+                if (ch != ' ' && ch != '\t') {
+                    *parts << op;
+                    cmdOperators << true;
+                }
+                break;
+            default:
+                part.append(ch);
+                break;
         }
     }
 
+    if (!part.isEmpty() || quoted) {
+        *parts << part;
+        cmdOperators << false;
+    }
+
+    // an empty command line consists of an empty command
+    if (parts->isEmpty()) {
+        *parts << part;
+        cmdOperators << false;
+    }
+
     return parts;
 }
 
+/**
+ * @brief TerminalWindow::parsePipeline
+ *   Splits the parts of a command line into the commands of a pipeline and their redirections.
+ *   A redirection belongs to the command it follows. Only the first command may read a file
+ *   and only the last command may write its output to a file, the other ones are connected
+ *   by the pipes. Only the parts marked in cmdOperators are operators.
+ * @param cmdParts
+ * @param pipeline  commands and redirections
+ * @return false = syntax error
+ */
+bool TerminalWindow::parsePipeline(QStringList *cmdParts, Pipeline &pipeline)
+{
+    QString     part;
+    QString     file;
+    Stage       stage;
+    QStringList operators = QStringList() << "|" << "<" << ">" << ">>" << "2>" << "2>>" << "2>&1";
+
+    for (int idx = 0; idx < cmdParts->size(); idx++) {
+        part = cmdParts->at(idx);
+
+        // quoted operators are arguments
+        if (!cmdOperators.value(idx)) {
+            stage.args << part;
+        } else if (part == "|") {
+            // the output of the command is the input of the next command
+            if (stage.args.isEmpty() || !stage.outFile.isEmpty()) return false;
+            pipeline.stages << stage;
+            stage = Stage();
+        } else if (part == "2>&1") {
+            stage.errToOut = true;
+        } else if (operators.contains(part)) {
+            // a redirection needs a filename
+            if (idx+1 >= cmdParts->size() || cmdOperators.value(idx+1)) return false;
+            idx++;
+            file = workDir->absoluteFilePath(cmdParts->at(idx));
+            if (part == "<") {
+                if (!pipeline.stages.isEmpty()) return false;
+                stage.inFile = file;
+            } else if (part.startsWith('2')) {
+                stage.errFile   = file;
+                stage.errAppend = (part == "2>>");
+            } else {
+                stage.outFile   = file;
+                stage.outAppend = (part == ">>");
+            }
+        } else {
+            return false;
+        }
+    }
+
+    if (stage.args.isEmpty()) return false;
+
+    pipeline.stages << stage;
+
+    return true;
+}
+
 /**
  * @brief TerminalWindow::commandInternal
  *   Executes commands build in Qt or the application.
@@ -222,6 +537,9 @@ void TerminalWindow::commandInternal(BuiltInCmds cmd, QStringList *cmdParts)
     bool result;
     bool dspDir = false;
     QString pathName;
+    Job *job;
+
+    beginEdit();
 
     currCursor = textCursor();
 
@@ -252,7 +570,6 @@ void TerminalWindow::commandInternal(BuiltInCmds cmd, QStringList *cmdParts)
             if (result) {
                 pathName = workDir->absolutePath();
                 wrkDrive = pathName.at(0);
-                process->setWorkingDirectory(pathName);
                 if (dspDir) {
                     currCursor.insertText(pathName+"\n");
                 }
@@ -261,52 +578,192 @@ void TerminalWindow::commandInternal(BuiltInCmds cmd, QStringList *cmdParts)
             }
             break;
         case CLEAR: {
+            stopWatch();
             currCursor = textCursor();
             currCursor.setPosition(0);
             QTextCharFormat cf = currCursor.charFormat();
-            this->clear();
+            currCursor.select(QTextCursor::Document);
+            currCursor.removeSelectedText();
+            scrollIndex->clear();
+            indexedBlocks = 0;
+            findBlock     = -1;
             currCursor.setCharFormat(cf);
             setTextCursor(currCursor); }
             break;
         case EXIT:
             break;
+        case JOBS:
+            for (int idx = 0; idx < jobs.size(); idx++) {
+                job = jobs.at(idx);
+                if (!job->finished) {
+                    currCursor.insertText("["+QString::number(job->id)+"] "+tr("Running")+"  "+job->cmdLine+"\n");
+                }
+            }
+            break;
+        case FG:
+            job = findJob(cmdParts);
+            if (job != nullptr) {
+                // the job's output is inserted at the end of the document from now on
+                job->background = false;
+                fgJob = job;
+                currCursor.insertText(job->cmdLine+"\n");
+                flushTimer->start();
+            } else {
+                currCursor.insertText(tr("Job not found!")+"\n");
+            }
+            break;
+        case KILL:
+            job = (cmdParts->size() > 1) ? findJob(cmdParts) : nullptr;
+            if (cmdParts->size() < 2) {
+                currCursor.insertText(tr("Usage: kill %job or kill [-signal] pid")+"\n");
+            } else if (job != nullptr) {
+                if (job->session != nullptr) job->session->signalCommand(SIGTERM);
+              #ifdef Q_OS_UNIX
+                if (job->pty != nullptr) job->pty->sendSignal(SIGTERM);
+              #endif
+                for (int num = 0; num < job->stages.size(); num++) {
+                  #ifdef Q_OS_UNIX
+                    job->stages.at(num)->terminate();
+                  #else
+                    job->stages.at(num)->kill();  // console applications don't handle the WM_CLOSE of terminate()
+                  #endif
+                }
+            } else {
+                currCursor.insertText(tr("Job not found!")+"\n");
+            }
+            break;
+        case WATCH: {
+            // watch [-n seconds] [command]; without a command the command selected in the library is watched
+            QRegularExpressionMatch match = QRegularExpression("^\\s*watch(?:\\s+-n\\s*([0-9]+(?:\\.[0-9]+)?))?(?:\\s+(.*))?$").match(lineEntered);
+            QString watched  = match.hasMatch() ? match.captured(2).trimmed() : QString();
+            int     interval = WATCHINTERVAL;
+            if (watched.isEmpty()) watched = entryCommand;
+            if (match.hasMatch() && !match.captured(1).isEmpty()) interval = qMax((int)(match.captured(1).toDouble()*1000),100);
+            if (!match.hasMatch() || watched.isEmpty()) {
+                currCursor.insertText(tr("No command to watch!")+"\n");
+            } else {
+                startWatch(watched,interval);
+            }}
+            break;
+        case SAVE:
+            // save file: copies the binary output of the last job to a file; an existing file isn't overwritten
+            if (cmdParts->size() < 2) {
+                currCursor.insertText(tr("Usage: save <file>")+"\n");
+            } else if (lastSpool == nullptr) {
+                currCursor.insertText(tr("No binary output to save!")+"\n");
+            } else {
+                cmdParts->pop_front();
+                pathName = cmdParts->join(' ');
+                if (pathName.startsWith('"')) pathName.remove(0,1);
+                if (pathName.endsWith('"')) pathName.chop(1);
+                pathName = workDir->absoluteFilePath(pathName);
+                if (QFile::exists(pathName)) {
+                    currCursor.insertText(tr("File already exists!")+"\n");
+                } else if (!QFile::copy(lastSpool->fileName(),pathName)) {
+                    currCursor.insertText(tr("Could not write the file!")+"\n");
+                } else {
+                    currCursor.insertText(tr("%1 bytes written to %2").arg(lastSpool->size()).arg(pathName)+"\n");
+                }
+            }
+            break;
         case NONE:
         default:
             break;
     }
 
-    currCursor.insertText("cmd$ ");
-    cmdLineStart = currCursor.position();
+    // Job brought to the foreground or command watched? => the prompt is displayed when the job or the watch is finished
+    if (fgJob == nullptr && !watching) {
+        currCursor.insertText("cmd$ ");
+    }
+
+    // the output of background jobs is inserted above the header of a watched command
+    cmdLineStart = watching ? watchHeader.position() : currCursor.position();
     cmdLineEnd   = cmdLineStart;
 
     setTextCursor(currCursor);
 
+    endEdit();
+
     return;
 }
 
 /**
  * @brief TerminalWindow::commandExternal
- *   Executes commands as processes.
+ *   Executes commands as processes. A command terminated by '&' is executed in the background.
  * @param cmdParts
  */
 void TerminalWindow::commandExternal(QStringList *cmdParts)
 {
-    bool result    = true;
-    bool dspPrompt = false;
+    bool result     = true;
+    bool dspPrompt  = false;
+    bool background = false;
+    QString cmdLine;
     QString command;
     QString argCmd;
     QString argLine;
     QStringList arguments;
+    LimitedProcess *process;
+    Pipeline    pipeline;
 
     currCursor = textCursor();
 
-    if (wrkDrive == '/') {
-        // execute a command under Linux
-        command = cmdParts->at(0);
-        for (lv::pos = 1; lv::pos < cmdParts->size(); lv::pos++) {
-            arguments << cmdParts->at(lv::pos);
+    // Run the command in the background? A quoted & is an argument.
+    if (cmdParts->last() == "&" && cmdOperators.value(cmdParts->size()-1)) {
+        cmdParts->removeLast();
+        cmdOperators.removeLast();
+        background = true;
+    }
+
+    // Pseudo terminal? => the command line is executed by a shell in the terminal
+    if (usePty && !background && !cmdParts->isEmpty()) {
+        executePty(lineEntered.trimmed());
+        return;
+    }
+
+    // The command selected in the library is cacheable? => a cached output in the same
+    // working directory and environment is replayed instead of executing the command.
+    // The environment of the persistent shell is changed by the session and unknown
+    // here, so the output of its commands isn't cached.
+    QString cacheKey;
+
+    if (cache != nullptr && shell == nullptr && !background && entryCacheTtl > 0 && lineEntered.trimmed() == entryCommand) {
+        QString cached;
+        int     cachedExit;
+        qint64  cachedAge;
+        cacheKey = ResultCache::key(entryCommand,workDir->absolutePath());
+        if (!refreshCache && cache->lookup(cacheKey,entryCacheTtl,cached,cachedExit,cachedAge)) {
+            replayCached(cached,cachedExit,cachedAge);
+            return;
+        }
+    }
+
+    // Persistent shell? => the command line is executed by the shell unchanged;
+    // background jobs are started as processes, so they can be controlled as jobs
+    if (shell != nullptr && !background && !cmdParts->isEmpty()) {
+        executeShell(lineEntered.trimmed());
+        return;
+    }
+
+    cmdLine = cmdParts->join(' ');
+
+    // Lists of commands (& or && inside of the command line) need a shell
+    bool cmdList = false;
+    for (int idx = 0; idx < cmdParts->size(); idx++) {
+        if (cmdOperators.value(idx) && cmdParts->at(idx).startsWith('&')) cmdList = true;
+    }
+
+    if (cmdParts->isEmpty()) {
+        dspPrompt = true;
+    } else if (cmdList) {
+        currCursor.insertText(tr("Syntax error!")+"\n");
+        dspPrompt = true;
+    } else if (wrkDrive == '/') {
+        // execute a command under Linux; the processes of a pipeline are connected directly,
+        // so only the output of the last process passes the terminal window
+        if (!parsePipeline(cmdParts,pipeline)) {
+            currCursor.insertText(tr("Syntax error!")+"\n");
+            dspPrompt = true;
         }
-        process->start(command,arguments);
     } else {
         // execute a command under Windows
         argCmd = cmdParts->at(0);
@@ -318,7 +775,6 @@ void TerminalWindow::commandExternal(QStringList *cmdParts)
                 currCursor.insertText(tr("Drive not available!")+"\n");
             } else {
                 wrkDrive = argCmd.at(0);
-                process->setWorkingDirectory(argCmd);
                 currCursor.insertText(workDir->absolutePath()+"\n");
             }
             dspPrompt = true;
@@ -333,7 +789,9 @@ void TerminalWindow::commandExternal(QStringList *cmdParts)
                 if (argLine.at(argLine.size()-1) == '"') argLine.remove(argLine.size()-1,1);
                 arguments << argLine;
             }
-            process->start(command,arguments);
+            Stage stage;
+            stage.args << command << arguments;
+            pipeline.stages << stage;
         }
     }
 
@@ -343,137 +801,2512 @@ void TerminalWindow::commandExternal(QStringList *cmdParts)
         cmdLineStart = currCursor.position();
         cmdLineEnd   = cmdLineStart;
         setTextCursor(currCursor);
+        return;
     }
 
-    return;
-}
+    // create a job with its own process and output buffer
+    Job *job = new Job;
 
-/**
- * @brief TerminalWindow::commandStarted
- *   Is called when the process is started. Then the process is in the running state.
- */
-void TerminalWindow::commandStarted()
-{
-  #ifdef DEBUG
-    cout << "Command started.\n";
-    cout.flush();
-  #endif
-    return;
-}
+    job->id = nextJobId();
 
-/**
- * @brief TerminalWindow::commandError
- *   Is called if there is an error during the execution.
- * @param error
- */
-void TerminalWindow::commandError(QProcess::ProcessError error)
-{
-    string errorMsg;
+    job->cmdLine    = cmdLine;
+    job->entered    = lineEntered.trimmed();
+    job->background = background;
+    job->cacheKey   = cacheKey;
 
-    errorMsg = "Error in executing command (";
+    // The decoders are created once per job and keep their state between the output blocks.
+    job->decoders[QProcess::StandardOutput] = new OutputDecoder(encoding);
+    job->decoders[QProcess::StandardError]  = new OutputDecoder(encoding);
 
-    if (error == 0) errorMsg+= "0=failed to start";
-    else if (error == 1) errorMsg+= "1=crashed";
-    else if (error == 2) errorMsg+= "2=timed out";
-    else if (error == 3) errorMsg+= "3=read error";
-    else if (error == 4) errorMsg+= "4=write error";
-    else if (error == 5) errorMsg+= "5=unknown error";
+    // create a process for each command of the pipeline
+    for (int idx = 0; idx < pipeline.stages.size(); idx++) {
+        process = new LimitedProcess(this);
 
-    errorMsg+= ")!\n";
+        process->setWorkingDirectory(workDir->absolutePath());
+        process->setLimits(jobLimits(job));
 
-    currCursor = textCursor();
+        connect(process,SIGNAL(started()),this,SLOT(commandStarted()));
+        connect(process,SIGNAL(errorOccurred(QProcess::ProcessError)),this,SLOT(commandError(QProcess::ProcessError)));
+        connect(process,SIGNAL(timedOut_signal()),this,SLOT(commandTimedOut()));
+        connect(process,SIGNAL(channelReadyRead(int)),this,SLOT(commandReadyRead(int)));
+        connect(process,SIGNAL(finished(int,QProcess::ExitStatus)),this,SLOT(commandFinished(int,QProcess::ExitStatus)));
 
-    currCursor.insertText(QString(errorMsg.c_str()));
-    currCursor.insertText("cmd$ ");
+        // the standard output of the previous process is the standard input of this process
+        if (idx > 0) {
+            job->stages.last()->setStandardOutputProcess(process);
+        }
 
-    cmdLineStart = currCursor.position();
-    cmdLineEnd   = cmdLineStart;
+        job->stages.append(process);
+    }
 
-    setTextCursor(currCursor);
+    job->process = job->stages.last();
 
-    // determine the vertical scrollbar of the QTextEdit element
-    QScrollBar *vsb = this->verticalScrollBar();
+    // redirections of each command of the pipeline
+    for (int idx = 0; idx < pipeline.stages.size(); idx++) {
+        const Stage &stage = pipeline.stages.at(idx);
+        QProcess *stageProcess = job->stages.at(idx);
+        if (!stage.inFile.isEmpty()) {
+            stageProcess->setStandardInputFile(stage.inFile);
+        }
+        if (!stage.outFile.isEmpty()) {
+            stageProcess->setStandardOutputFile(stage.outFile,stage.outAppend ? QIODevice::Append : QIODevice::Truncate);
+        }
+        if (!stage.errFile.isEmpty()) {
+            stageProcess->setStandardErrorFile(stage.errFile,stage.errAppend ? QIODevice::Append : QIODevice::Truncate);
+        }
+        // the error output is merged into the output, which may be the pipe to the next command
+        if (stage.errToOut) {
+            stageProcess->setProcessChannelMode(QProcess::MergedChannels);
+        }
+    }
 
-    // get the maximum position of the slider and then setup slider's position to the maximum
-    // maximum position = length of the document - length of the page
-    int sliderMax = vsb->maximum();
+    // the lines entered while the job runs in the foreground are the input of the first process
+    if (pipeline.stages.first().inFile.isEmpty()) {
+        job->stdinProcess = job->stages.first();
+        connect(job->stdinProcess,SIGNAL(bytesWritten(qint64)),this,SLOT(inputWritten(qint64)));
+    }
 
-    vsb->setSliderPosition(sliderMax);
+    jobs.append(job);
+
+    if (background) {
+        // the job number is displayed and then the prompt for the next command
+        currCursor.insertText("["+QString::number(job->id)+"] "+job->cmdLine+"\n");
+        currCursor.insertText("cmd$ ");
+        cmdLineStart = currCursor.position();
+        cmdLineEnd   = cmdLineStart;
+        setTextCursor(currCursor);
+    } else {
+        fgJob = job;
+    }
+
+    // resource usage at the start of the job
+    job->wallTimer.start();
+    job->procsFinishedStart = procsFinished;
+  #ifdef Q_OS_UNIX
+    getrusage(RUSAGE_CHILDREN,&job->usageStart);
+  #endif
+  #ifdef Q_OS_LINUX
+    if (!sampleTimer->isActive()) sampleTimer->start();
+  #endif
+
+    for (int idx = 0; idx < pipeline.stages.size(); idx++) {
+        job->stages.at(idx)->start(pipeline.stages.at(idx).args.first(),pipeline.stages.at(idx).args.mid(1));
+    }
 
     return;
 }
 
 /**
- * @brief TerminalWindow::commandReadyRead
- *   Is called if there is a command output available in the process.
- * @param channel
+ * @brief TerminalWindow::deleteJob
+ *   Deletes a job removed from the job list. Processes of the pipeline still running are killed.
+ * @param job
  */
-void TerminalWindow::commandReadyRead(int channel)
+void TerminalWindow::deleteJob(Job *job)
 {
-    QString    strData;
-    QByteArray buffData;
-    int        buffSize;
+    for (int idx = 0; idx < job->stages.size(); idx++) {
+        job->stages.at(idx)->disconnect(this);
+        job->stages.at(idx)->deleteLater();
+    }
 
-  #ifdef DEBUG
-    cout << "Command output read.\n";
-    cout.flush();
-  #endif
+    if (job->pty != nullptr) {
+        job->pty->disconnect(this);
+        job->pty->deleteLater();
+    }
 
-    currCursor = textCursor();
+    // binary output of the job? => kept for the built in command save
+    if (job->spool != nullptr) {
+        delete lastSpool;
+        lastSpool = job->spool;
+    }
 
-    process->setCurrentReadChannel(channel);
+    delete job->ansi;
+    delete job->decoders[QProcess::StandardOutput];
+    delete job->decoders[QProcess::StandardError];
+    delete job;
 
-    // returns an installed QTextCodec for the IBM 850 encoding; Windows-1252 not usable due to the umlauts
-    // in the character set Windows-1252 are on another position than the umlauts in the ASCII character set
-    QTextCodec *codec = QTextCodec::codecForName("IBM 850");
+    return;
+}
 
-    // auto=alias for QStringDecoder; Latin1 not usable due to the character set contains control characters
-    // in the range from 80h to 9Fh
-    //QStringDecoder/*auto*/ toUtf16 = QStringDecoder(QStringDecoder::Latin1);
+/**
+ * @brief TerminalWindow::findJob
+ *   Determines the job of a process.
+ * @param process
+ * @return job or nullptr
+ */
+TerminalWindow::Job *TerminalWindow::findJob(QObject *process)
+{
+    for (int idx = 0; idx < jobs.size(); idx++) {
+        if (jobs.at(idx)->stages.contains((QProcess *)process)) return jobs.at(idx);
+        if (jobs.at(idx)->session != nullptr && jobs.at(idx)->session == process) return jobs.at(idx);
+        if (jobs.at(idx)->pty != nullptr && jobs.at(idx)->pty == process) return jobs.at(idx);
+    }
 
-    do {
-        buffData = process->read(64);
-        buffSize = buffData.size();
+    return nullptr;
+}
 
-        // Exists the needed Codec?
-        if (codec != nullptr && wrkDrive != '/') {
-            strData = codec->toUnicode(buffData);
-          //QString strData = toUtf16.decode(buffData)/*toUtf16(buffData)*/;
-        } else {
-            strData = QString(buffData);
+/**
+ * @brief TerminalWindow::findJob
+ *   Determines the job passed to the built in commands fg and kill
+ *   as number (1) or job specification (%1).
+ * @param cmdParts
+ * @return job or nullptr; without a job number the last started background job
+ */
+TerminalWindow::Job *TerminalWindow::findJob(QStringList *cmdParts)
+{
+    bool convOk;
+    int  id;
+    Job *job;
+
+    if (cmdParts->size() > 1) {
+        QString jobSpec = cmdParts->at(1);
+        if (jobSpec.startsWith('%')) jobSpec.remove(0,1);
+        id = jobSpec.toInt(&convOk,10);
+        for (int idx = 0; convOk && idx < jobs.size(); idx++) {
+            job = jobs.at(idx);
+            if (job->id == id && !job->finished) return job;
+        }
+    } else {
+        for (int idx = jobs.size()-1; idx >= 0; idx--) {
+            job = jobs.at(idx);
+            if (job->background && !job->finished) return job;
         }
+    }
+
+    return nullptr;
+}
 
-        currCursor.insertText(strData);
+/**
+ * @brief TerminalWindow::interruptJob
+ *   Interrupts a job like Ctrl-C in a terminal.
+ * @param job
+ */
+void TerminalWindow::interruptJob(Job *job)
+{
+    if (job->finished) return;
+
+    // Command executed in a pseudo terminal? => the process group of the command is interrupted
+    if (job->pty != nullptr) {
+      #ifdef Q_OS_UNIX
+        job->pty->sendSignal(SIGINT);
+      #endif
+        return;
+    }
 
-    } while (buffSize >= 64);
+    // Command executed by the persistent shell? => the shell itself isn't interrupted
+    if (job->session != nullptr) {
+        job->output+= ANSIRESET "^C\n";
+        job->session->signalCommand(SIGINT);
+        return;
+    }
 
-    setTextCursor(currCursor);
+    // Process not running (anymore)?
+    if (job->process->state() != QProcess::Running) return;
+
+    job->output+= ANSIRESET "^C\n";
+
+    // all processes of the pipeline are interrupted
+    for (int idx = 0; idx < job->stages.size(); idx++) {
+        QProcess *process = job->stages.at(idx);
+        if (process->state() != QProcess::Running) continue;
+      #ifdef Q_OS_UNIX
+        ::kill((pid_t)process->processId(),SIGINT);
+      #else
+        process->kill();
+      #endif
+    }
+
+    if (!flushTimer->isActive()) {
+        flushTimer->start();
+    }
 
     return;
 }
 
 /**
- * @brief TerminalWindow::commandFinished
- *   Is called when the process is finished. Then the process is in the not running state.
- * @param exitCode
- * @param exitStatus
+ * @brief TerminalWindow::commandStarted
+ *   Is called when the process is started. Then the process is in the running state.
  */
-void TerminalWindow::commandFinished(int exitCode, QProcess::ExitStatus exitStatus)
+void TerminalWindow::commandStarted()
 {
   #ifdef DEBUG
-    cout << "Command executing finished.\n";
+    cout << "Command started.\n";
     cout.flush();
   #endif
+    return;
+}
 
-    currCursor = textCursor();
+/**
+ * @brief TerminalWindow::commandError
+ *   Is called if there is an error during the execution.
+ * @param error
+ */
+void TerminalWindow::commandError(QProcess::ProcessError error)
+{
+    Job *job = findJob(sender());
+
+    if (job == nullptr) return;
+
+    // the processes killed after a timeout aren't reported as crashed
+    if (error == QProcess::Crashed && job->timedOut) return;
+
+    jobError(job,sender(),error);
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::jobLimits
+ *   The command selected in the library is executed with its own limits, if it wasn't changed.
+ * @param job
+ * @return limits of the processes of the job
+ */
+const LimitedProcess::Limits &TerminalWindow::jobLimits(Job *job)
+{
+    return (!entryCommand.isEmpty() && job->entered == entryCommand) ? entryLimits : limits;
+}
+
+/**
+ * @brief TerminalWindow::commandTimedOut
+ *   Is called if a process, a pseudo terminal or the persistent shell exceeded the wall
+ *   clock time of its limits. All processes of the job are killed; the job finishes as
+ *   usual with the finished() of its processes. The persistent shell terminates the
+ *   command itself.
+ */
+void TerminalWindow::commandTimedOut()
+{
+    Job *job = findJob(sender());
+
+    if (job == nullptr || job->finished || job->timedOut) return;
+
+    job->timedOut = true;
+
+    jobError(job,sender(),QProcess::Timedout);
+
+    for (int idx = 0; idx < job->stages.size(); idx++) {
+        if (job->stages.at(idx)->state() != QProcess::NotRunning) job->stages.at(idx)->kill();
+    }
+
+  #ifdef Q_OS_UNIX
+    if (job->pty != nullptr) job->pty->sendSignal(SIGKILL);
+  #endif
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::jobError
+ *   Inserts the message of an error of a process into the output of its job.
+ * @param job
+ * @param process
+ * @param error
+ */
+void TerminalWindow::jobError(Job *job, QObject *process, QProcess::ProcessError error)
+{
+    string errorMsg;
+
+    errorMsg = "Error in executing command (";
+
+    if (error == 0) errorMsg+= "0=failed to start";
+    else if (error == 1) errorMsg+= "1=crashed";
+    else if (error == 2) errorMsg+= "2=timed out";
+    else if (error == 3) errorMsg+= "3=read error";
+    else if (error == 4) errorMsg+= "4=write error";
+    else if (error == 5) errorMsg+= "5=unknown error";
+
+    errorMsg+= ")!\n";
+
+    // the message is inserted after the output read until the error occured
+    if (!job->output.isEmpty() && !job->output.endsWith('\n')) job->output+= '\n';
+    job->output+= ANSIRESET + QString(errorMsg.c_str());
+
+    // A process not started doesn't emit finished().
+    if (error == QProcess::FailedToStart && process == job->process) {
+        job->finished = true;
+        job->exitCode = -1;
+    }
+
+    if (!flushTimer->isActive()) {
+        flushTimer->start();
+    }
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::sendInput
+ *   Queues input for the standard input of a job. The input is written in portions
+ *   by writeInput(), so large pastes don't block the event loop.
+ * @param job
+ * @param text
+ */
+void TerminalWindow::sendInput(Job *job, const QString &text)
+{
+    if (text.isEmpty()) return;
+
+    // the persistent shell queues the input of its command itself
+    if (job->session != nullptr) {
+        job->session->writeInput(OutputDecoder::encode(text,encoding));
+        return;
+    }
+
+    if (job->stdinProcess == nullptr) return;
+
+    job->input+= OutputDecoder::encode(text,encoding);
+
+    writeInput(job);
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::writeInput
+ *   Writes queued input to the standard input of a job. At most STDINCHUNK bytes wait in
+ *   the write buffer of the process; the next portion is written when the process reports
+ *   written bytes. After Ctrl-D the standard input is closed as soon as the queue is empty.
+ * @param job
+ */
+void TerminalWindow::writeInput(Job *job)
+{
+    QProcess *process = job->stdinProcess;
+    qint64    size;
+
+    if (process == nullptr) return;
+
+    // Process terminated? => the input isn't read anymore
+    if (process->state() == QProcess::NotRunning) {
+        job->input.clear();
+        job->inputPos     = 0;
+        job->stdinProcess = nullptr;
+        return;
+    }
+
+    while (job->inputPos < job->input.size() && process->bytesToWrite() < STDINCHUNK) {
+        size = process->write(job->input.constData()+job->inputPos,qMin((qint64)STDINCHUNK,(qint64)(job->input.size()-job->inputPos)));
+        if (size <= 0) break;
+        job->inputPos+= size;
+    }
+
+    if (job->inputPos >= job->input.size()) {
+        job->input.clear();
+        job->inputPos = 0;
+        // the write channel is closed after the buffered bytes are written
+        if (job->inputEof) {
+            process->closeWriteChannel();
+            job->stdinProcess = nullptr;
+        }
+    } else if (job->inputPos > job->input.size()/2) {
+        // the written half of the queue is removed; the bytes are moved only once on average
+        job->input.remove(0,job->inputPos);
+        job->inputPos = 0;
+    }
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::inputWritten
+ *   Is called if a process read bytes of its standard input.
+ * @param bytes
+ */
+void TerminalWindow::inputWritten(qint64 bytes)
+{
+    Q_UNUSED(bytes);
+
+    Job *job = findJob(sender());
+
+    if (job != nullptr) {
+        writeInput(job);
+    }
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::insertFromMimeData
+ *   Pastes text. While a job runs in the foreground, the complete lines of the entered
+ *   and the pasted text are its input; large pastes aren't displayed but summarized.
+ *   In a pseudo terminal the pasted text is typed and echoed by the terminal.
+ * @param source
+ */
+void TerminalWindow::insertFromMimeData(const QMimeData *source)
+{
+    QString input;
+    QString rest;
+    int     size;
+
+    if (fgJob == nullptr || fgJob->finished || !source->hasText() ||
+        (fgJob->pty == nullptr && fgJob->stdinProcess == nullptr && fgJob->session == nullptr)) {
+        QPlainTextEdit::insertFromMimeData(source);
+        return;
+    }
+
+    if (fgJob->pty != nullptr) {
+        fgJob->pty->write(source->text().replace('\n','\r').toUtf8());
+        return;
+    }
+
+    input = getCommandLine().replace(QChar(0x2029),'\n') + source->text().replace("\r\n","\n");
+    size  = input.lastIndexOf('\n') + 1;
+
+    // No complete line? => the text is edited as usual
+    if (size == 0) {
+        QPlainTextEdit::insertFromMimeData(source);
+        return;
+    }
+
+    rest = input.mid(size);
+    input.truncate(size);
+
+    beginEdit();
+
+    QTextCursor cursor(document());
+
+    cursor.setPosition(cmdLineStart);
+    cursor.movePosition(QTextCursor::End,QTextCursor::KeepAnchor);
+
+    if (input.size() <= PASTEECHO) {
+        cursor.insertText(input);
+    } else {
+        cursor.insertText("["+tr("%1 characters of input pasted").arg(input.size())+"]\n");
+    }
+
+    cmdLineStart = cursor.position();
+    cmdLineEnd   = cmdLineStart;
+
+    cursor.insertText(rest);
+    setTextCursor(cursor);
+
+    endEdit();
+
+    scrollToEnd();
+
+    sendInput(fgJob,input);
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::commandReadyRead
+ *   Is called if there is a command output available in the process.
+ * @param channel
+ */
+void TerminalWindow::commandReadyRead(int channel)
+{
+    Job *job = findJob(sender());
+
+    if (job != nullptr) {
+        readJobOutput(job,(QProcess *)sender(),channel);
+    }
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::readJobOutput
+ *   Reads the output of a job's process to the job's output buffer. The buffers of
+ *   all jobs are inserted into the document by flushOutput(). The lines of background
+ *   jobs start with the job number.
+ * @param job
+ * @param process  process of the job's pipeline
+ * @param channel
+ */
+void TerminalWindow::readJobOutput(Job *job, QProcess *process, int channel)
+{
+    QString    strData;
+    QByteArray buffData;
+
+    process->setCurrentReadChannel(channel);
+
+    buffData = process->readAll();
+
+    if (buffData.isEmpty()) return;
+
+    // binary output isn't decoded and inserted into the document
+    if (channel == QProcess::StandardOutput && binaryOutput(job,buffData)) return;
+
+    // the decoder of the channel keeps characters split between two blocks
+    strData = job->decoders[channel]->decode(buffData);
+
+    if (sessionLog != nullptr) sessionLog->output(job->id,channel,strData);
+
+    captureOutput(job,strData);
+
+    if (job->background) {
+        QString prefix = "["+QString::number(job->id)+"] ";
+        int pos = 0;
+        int posNL;
+
+        while (pos < strData.size()) {
+            if (job->lineStart) {
+                job->output+= prefix;
+                job->lineStart = false;
+            }
+            posNL = strData.indexOf('\n',pos);
+            if (posNL < 0) {
+                job->output+= strData.mid(pos);
+                break;
+            }
+            job->output+= strData.mid(pos,posNL-pos+1);
+            job->lineStart = true;
+            pos = posNL + 1;
+        }
+    } else {
+        job->output+= strData;
+    }
+
+    // start the interval for inserting the output if it isn't already running
+    if (!flushTimer->isActive()) {
+        flushTimer->start();
+    }
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::insertTerminalText
+ *   Inserts output of a pseudo terminal. The terminal echo erases characters with backspace,
+ *   progress indicators rewrite the line after a carriage return.
+ * @param cursor
+ * @param text
+ * @param format
+ */
+void TerminalWindow::insertTerminalText(QTextCursor &cursor, const QString &text, const QTextCharFormat &format)
+{
+    int from = 0;
+
+    for (int pos = 0; pos < text.size(); pos++) {
+        if (text.at(pos) != '\b' && text.at(pos) != '\r') continue;
+        cursor.insertText(text.mid(from,pos-from),format);
+        if (text.at(pos) == '\b') {
+            if (cursor.positionInBlock() > 0) cursor.deletePreviousChar();
+        } else {
+            cursor.movePosition(QTextCursor::StartOfBlock,QTextCursor::KeepAnchor);
+            cursor.removeSelectedText();
+        }
+        from = pos+1;
+    }
+
+    cursor.insertText(text.mid(from),format);
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::flushOutput
+ *   Inserts the collected output of the jobs into the document. Is called by the flush
+ *   timer at most once per frame. The output of the foreground job is appended to the
+ *   document. While the prompt is displayed, complete lines of background jobs are
+ *   inserted in front of the prompt line.
+ */
+void TerminalWindow::flushOutput()
+{
+    int  size;
+    int  budget   = FLUSHMAXCHARS;  // maximum number of characters inserted in this interval
+    bool inserted = false;
+    Job *job;
+
+    flushTimer->stop();
+
+    QTextCursor cursor(document());
+
+    // one edit block => the document is laid out only once for the inserted output
+    beginEdit();
+
+    for (int idx = 0; idx < jobs.size() && budget > 0; idx++) {
+        job = jobs.at(idx);
+
+        if (job->output.isEmpty()) continue;
+
+        if (fgJob == nullptr) {
+            // only complete lines; the output of a finished job ends with a new line
+            size = job->finished ? job->output.size() : job->output.lastIndexOf('\n') + 1;
+            if (size > budget) {
+                size = job->output.lastIndexOf('\n',budget-1) + 1;
+                if (size == 0) size = budget;
+            }
+            if (size == 0) continue;
+            insertJobOutput(cursor,job,size,true);
+        } else {
+            // Very large output is inserted in portions of FLUSHMAXCHARS per interval,
+            // so the event loop isn't blocked by the layout of the whole output.
+            size = qMin((int)job->output.size(),budget);
+            insertJobOutput(cursor,job,size,false);
+        }
+
+        budget-= size;
+        inserted = true;
+    }
+
+    // remove the finished jobs with completely inserted output
+    for (int idx = jobs.size()-1; idx >= 0; idx--) {
+        job = jobs.at(idx);
+
+        if (!job->finished || !job->output.isEmpty()) continue;
+
+        jobs.removeAt(idx);
+
+        // Foreground job finished? => display the prompt again
+        if (job == fgJob) {
+            fgJob = nullptr;
+            cursor.movePosition(QTextCursor::End);
+            cursor.insertText("cmd$ ",plainFormat);
+            cmdLineStart = cursor.position();
+            cmdLineEnd   = cmdLineStart;
+            inserted = true;
+        }
+
+        deleteJob(job);
+    }
+
+    trimScrollback(cursor);
+
+    endEdit();
+
+    syncIndex();
+
+    // Output left? => insert it in the next interval
+    if (budget <= 0) {
+        flushTimer->start();
+    }
+
+    if (inserted) {
+        // the text cursor is placed at the end, if the output is appended to the document
+        if (cmdLineStart >= document()->characterCount() - 1) {
+            currCursor = textCursor();
+            currCursor.movePosition(QTextCursor::End);
+            setTextCursor(currCursor);
+        }
+        scrollToEnd();
+        if (findBar->isVisible()) {
+            highlightHits();
+            countTimer->start();
+        }
+    }
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::insertJobOutput
+ *   Moves output of a job from the job's output buffer into the document.
+ * @param cursor        cursor of the edit block of flushOutput()
+ * @param job
+ * @param size          number of characters to insert
+ * @param beforePrompt  true = insert the output in front of the prompt line
+ */
+void TerminalWindow::insertJobOutput(QTextCursor &cursor, Job *job, int size, bool beforePrompt)
+{
+    int posStart;
+
+    if (beforePrompt) {
+        cursor.setPosition(document()->findBlock(cmdLineStart).position());
+        // inserted above the end of the document? => the following lines of the index move
+        if (cursor.blockNumber() < indexedBlocks) {
+            scrollIndex->truncate(cursor.blockNumber());
+            indexedBlocks = cursor.blockNumber();
+        }
+    } else {
+        cursor.movePosition(QTextCursor::End);
+    }
+
+    posStart = cursor.position();
+
+    // A carriage return at the end may be the beginning of \r\n? => it's inserted with the next output
+    if (size > 0 && size == job->output.size() && job->output.endsWith('\r') && !job->finished) size--;
+
+    // The escape sequences are parsed with the state of the previous output of the job;
+    // each run of text with the same format is inserted at once.
+    if (job->ansi == nullptr) job->ansi = new AnsiParser(plainFormat);
+
+    QString text = job->output.left(size);
+    const QList<AnsiParser::Run> &runs = job->ansi->parse(text);
+
+    for (int idx = 0; idx < runs.size(); idx++) {
+        if (!beforePrompt && job->pty != nullptr) {
+            insertTerminalText(cursor,text.mid(runs.at(idx).start,runs.at(idx).length),runs.at(idx).format);
+        } else {
+            cursor.insertText(text.mid(runs.at(idx).start,runs.at(idx).length),runs.at(idx).format);
+        }
+    }
+
+    job->output.remove(0,size);
+
+    if (beforePrompt) {
+        // the command line is moved by the inserted characters (\r\n is inserted as one character)
+        cmdLineStart+= cursor.position() - posStart;
+        cmdLineEnd  += cursor.position() - posStart;
+    } else {
+        // input for the foreground job starts after its output
+        cmdLineStart = cursor.position();
+        cmdLineEnd   = cmdLineStart;
+    }
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::setScrollback
+ *   Sets the limits of the scrollback. If a limit is exceeded, the oldest lines are removed.
+ * @param lines  maximum number of lines; 0 = unlimited
+ * @param chars  maximum number of characters; 0 = unlimited
+ */
+void TerminalWindow::setScrollback(int lines, int chars)
+{
+    scrollbackLines = (lines > 0) ? lines : 0;
+    scrollbackChars = (chars > 0) ? chars : 0;
+
+    currCursor = textCursor();
+    beginEdit();
+    trimScrollback(currCursor);
+    endEdit();
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::setBackend
+ *   Sets the backend executing the external commands. With the backend "bash" the commands
+ *   are executed by a persistent shell under Linux, with the backend "pty" every command is
+ *   executed in a pseudo terminal; otherwise every command is started as process.
+ * @param backend
+ */
+void TerminalWindow::setBackend(const QString &backend)
+{
+    usePty = (backend == "pty" && wrkDrive == '/');
+
+    if (backend == "bash" && wrkDrive == '/') {
+        if (shell == nullptr) {
+            shell = new ShellSession(this);
+            connect(shell,SIGNAL(output_signal(QString)),this,SLOT(shellOutput(QString)));
+            connect(shell,SIGNAL(done_signal(int,QString)),this,SLOT(shellDone(int,QString)));
+            connect(shell,SIGNAL(timedOut_signal()),this,SLOT(commandTimedOut()));
+            shell->setLimits(limits);
+        }
+    } else if (shell != nullptr && !shell->isBusy()) {
+        delete shell;
+        shell = nullptr;
+    }
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::executeShell
+ *   Executes a command line in the persistent shell as foreground job.
+ * @param line
+ */
+void TerminalWindow::executeShell(const QString &line)
+{
+    Job *job = new Job;
+
+    job->id = nextJobId();
+
+    job->cmdLine    = line;
+    job->entered    = line;
+    job->background = false;
+    job->session    = shell;
+
+    job->wallTimer.start();
+    job->procsFinishedStart = procsFinished;
+  #ifdef Q_OS_UNIX
+    getrusage(RUSAGE_CHILDREN,&job->usageStart);
+  #endif
+
+    jobs.append(job);
+    fgJob = job;
+
+    if (!shell->execute(line,workDir->absolutePath(),jobLimits(job).timeout)) {
+        job->output+= tr("Shell not available!")+"\n";
+        job->finished = true;
+        job->exitCode = -1;
+        flushTimer->start();
+        return;
+    }
+
+    // the shell keeps the limits it was started with, so the state of the session isn't lost
+    if (!shell->appliesLimits(jobLimits(job))) {
+        job->output+= tr("Limits not applied: the shell was started with other limits!")+"\n";
+        flushTimer->start();
+    }
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::nextJobId
+ * @return number of a new job; one more than the highest number of the existing jobs
+ */
+int TerminalWindow::nextJobId()
+{
+    int id = 1;
+
+    for (int idx = 0; idx < jobs.size(); idx++) {
+        if (jobs.at(idx)->id >= id) id = jobs.at(idx)->id + 1;
+    }
+
+    return id;
+}
+
+/**
+ * @brief TerminalWindow::terminalSize
+ *   Determines the number of columns and rows of the visible part of the terminal window.
+ * @param cols
+ * @param rows
+ */
+void TerminalWindow::terminalSize(int &cols, int &rows)
+{
+    QFontMetrics metrics(currCursor.charFormat().font());
+
+    cols = qMax(viewport()->width() / qMax(metrics.horizontalAdvance('M'),1),1);
+    rows = qMax(viewport()->height() / qMax(metrics.lineSpacing(),1),1);
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::resizeEvent
+ *   Passes the new size of the terminal window on to the commands running in a pseudo terminal.
+ * @param event
+ */
+void TerminalWindow::resizeEvent(QResizeEvent *event)
+{
+    int cols;
+    int rows;
+
+    QPlainTextEdit::resizeEvent(event);
+
+    placeFindBar();
+
+    terminalSize(cols,rows);
+
+    for (int idx = 0; idx < jobs.size(); idx++) {
+        if (jobs.at(idx)->pty != nullptr) jobs.at(idx)->pty->setWindowSize(cols,rows);
+    }
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::executePty
+ *   Executes a command line in a pseudo terminal as foreground job. The command line is
+ *   interpreted by /bin/sh, so pipes and redirections work as in a terminal.
+ * @param line
+ */
+void TerminalWindow::executePty(const QString &line)
+{
+    int  cols;
+    int  rows;
+    Job *job = new Job;
+
+    job->id         = nextJobId();
+    job->cmdLine    = line;
+    job->entered    = line;
+    job->background = false;
+    job->pty        = new PtyProcess(this);
+
+    // the terminal merges the standard output and the standard error channel
+    job->decoders[QProcess::StandardOutput] = new OutputDecoder(encoding);
+
+    connect(job->pty,SIGNAL(output_signal(QByteArray)),this,SLOT(ptyOutput(QByteArray)));
+    connect(job->pty,SIGNAL(finished_signal(int,bool)),this,SLOT(ptyFinished(int,bool)));
+    connect(job->pty,SIGNAL(timedOut_signal()),this,SLOT(commandTimedOut()));
+
+    job->pty->setLimits(jobLimits(job));
+
+    job->wallTimer.start();
+    job->procsFinishedStart = procsFinished;
+  #ifdef Q_OS_UNIX
+    getrusage(RUSAGE_CHILDREN,&job->usageStart);
+  #endif
+
+    jobs.append(job);
+    fgJob = job;
+
+    terminalSize(cols,rows);
+
+    if (!job->pty->start("/bin/sh",QStringList() << "-c" << line,workDir->absolutePath(),cols,rows)) {
+        job->output+= tr("Pseudo terminal not available!")+"\n";
+        job->finished = true;
+        job->exitCode = -1;
+        flushTimer->start();
+        return;
+    }
+
+  #ifdef Q_OS_LINUX
+    if (!sampleTimer->isActive()) sampleTimer->start();
+  #endif
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::forwardKey
+ *   Passes a pressed key on to the command running in a pseudo terminal. Special keys are
+ *   converted to the control characters and escape sequences of a terminal.
+ * @param event
+ */
+void TerminalWindow::forwardKey(QKeyEvent *event)
+{
+    QByteArray data;
+
+    switch (event->key()) {
+        case Qt::Key_Return:
+        case Qt::Key_Enter:     data = "\r";      break;
+        case Qt::Key_Backspace: data = "\x7f";    break;
+        case Qt::Key_Tab:       data = "\t";      break;
+        case Qt::Key_Escape:    data = "\x1b";    break;
+        case Qt::Key_Up:        data = "\x1b[A";  break;
+        case Qt::Key_Down:      data = "\x1b[B";  break;
+        case Qt::Key_Right:     data = "\x1b[C";  break;
+        case Qt::Key_Left:      data = "\x1b[D";  break;
+        case Qt::Key_Home:      data = "\x1b[H";  break;
+        case Qt::Key_End:       data = "\x1b[F";  break;
+        case Qt::Key_Delete:    data = "\x1b[3~"; break;
+        case Qt::Key_PageUp:    data = "\x1b[5~"; break;
+        case Qt::Key_PageDown:  data = "\x1b[6~"; break;
+        default:
+            // Ctrl-A ... Ctrl-Z => control characters 01h ... 1Ah; e.g. Ctrl-C = interrupt, Ctrl-D = end of input
+            if ((event->modifiers() & Qt::ControlModifier) && event->key() >= Qt::Key_A && event->key() <= Qt::Key_Z) {
+                data.append((char)(event->key() - Qt::Key_A + 1));
+            } else {
+                data = event->text().toUtf8();
+            }
+            break;
+    }
+
+    if (!data.isEmpty()) {
+        fgJob->pty->write(data);
+    }
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::ptyOutput
+ *   Is called if a command running in a pseudo terminal wrote output. The terminal
+ *   ends the lines with \r\n.
+ * @param data
+ */
+void TerminalWindow::ptyOutput(QByteArray data)
+{
+    Job *job = findJob(sender());
+
+    if (job == nullptr) return;
+
+    if (binaryOutput(job,data)) return;
+
+    QString text = job->decoders[QProcess::StandardOutput]->decode(data);
+
+    if (sessionLog != nullptr) sessionLog->output(job->id,QProcess::StandardOutput,text);
+
+    // only the new text is converted; a \r at its end is kept until the next output shows whether \n follows
+    if (job->ptyReturn) {
+        text.prepend('\r');
+        job->ptyReturn = false;
+    }
+    if (text.endsWith('\r')) {
+        text.chop(1);
+        job->ptyReturn = true;
+    }
+
+    text.replace("\r\n","\n");
+
+    job->output+= text;
+
+    if (!flushTimer->isActive()) {
+        flushTimer->start();
+    }
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::ptyFinished
+ *   Is called if the command running in a pseudo terminal terminated.
+ * @param exitCode
+ * @param crashed
+ */
+void TerminalWindow::ptyFinished(int exitCode, bool crashed)
+{
+    Job *job = findJob(sender());
+
+    if (job == nullptr) return;
+
+    procsFinished++;
+    job->procsFinished++;
+
+    job->finished   = true;
+    job->exitCode   = exitCode;
+    job->exitStatus = crashed ? QProcess::CrashExit : QProcess::NormalExit;
+
+    // a carriage return at the end isn't followed by a new line anymore
+    job->ptyReturn = false;
+
+    binarySummary(job);
+
+    QString usage = profileJob(job);
+
+    if (dspProfile) {
+        if (!job->output.isEmpty() && !job->output.endsWith('\n')) job->output+= '\n';
+        job->output+= ANSIRESET "["+usage+"]\n";
+    }
+
+    if (!flushTimer->isActive()) {
+        flushTimer->start();
+    }
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::shellOutput
+ *   Is called if the persistent shell passes on output of a command.
+ * @param text
+ */
+void TerminalWindow::shellOutput(QString text)
+{
+    Job *job = findJob(sender());
+
+    if (job == nullptr) return;
+
+    if (sessionLog != nullptr) sessionLog->output(job->id,QProcess::StandardOutput,text);
+
+    captureOutput(job,text);
+
+    job->output+= text;
+
+    if (!flushTimer->isActive()) {
+        flushTimer->start();
+    }
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::shellDone
+ *   Is called if the persistent shell finished a command. The working directory of the
+ *   terminal window follows the working directory of the shell.
+ * @param exitCode
+ * @param pwd  working directory of the shell; empty if the shell terminated
+ */
+void TerminalWindow::shellDone(int exitCode, QString pwd)
+{
+    Job *job = findJob(sender());
+
+    if (job == nullptr) return;
+
+    if (!pwd.isEmpty()) workDir->cd(pwd);
+
+    job->finished = true;
+    job->exitCode = exitCode;
+
+    // pwd is empty if the shell terminated during the command
+    if (pwd.isEmpty()) job->exitStatus = QProcess::CrashExit;
+
+    cacheJob(job);
+
+    QString usage = profileJob(job);
+
+    if (dspProfile) {
+        if (!job->output.isEmpty() && !job->output.endsWith('\n')) job->output+= '\n';
+        job->output+= ANSIRESET "["+usage+"]\n";
+    }
+
+    if (!flushTimer->isActive()) {
+        flushTimer->start();
+    }
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::setSessionLog
+ *   Starts logging the entered commands and their output to a file.
+ * @param fn        filename of the log file; empty = no log
+ * @param maxMB     maximum size of the log file in MB before it's compressed to a segment
+ * @param segments  number of compressed segments kept
+ */
+void TerminalWindow::setSessionLog(const QString &fn, int maxMB, int segments)
+{
+    delete sessionLog;
+    sessionLog = nullptr;
+
+    if (fn.isEmpty()) return;
+
+    sessionLog = new SessionLog(fn,(qint64)maxMB*1048576,segments);
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::setLimits
+ *   Sets the limits of the processes of the external commands.
+ * @param lim
+ */
+void TerminalWindow::setLimits(const LimitedProcess::Limits &lim)
+{
+    limits = lim;
+
+    if (shell != nullptr) shell->setLimits(limits);
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::setEntry
+ *   Sets the limits and the caching of the command selected in the library; they apply
+ *   if the command is executed unchanged.
+ * @param cmd
+ * @param lim       limits replacing the default limits
+ * @param cacheTtl  time to live of the cached output in seconds; 0 = not cached
+ */
+void TerminalWindow::setEntry(const QString &cmd, const LimitedProcess::Limits &lim, int cacheTtl)
+{
+    entryCommand  = cmd.trimmed();
+    entryLimits   = lim;
+    entryCacheTtl = cacheTtl;
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::setCache
+ *   Sets the cache of the outputs of the cacheable commands.
+ * @param resCache
+ */
+void TerminalWindow::setCache(ResultCache *resCache)
+{
+    cache = resCache;
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::binaryOutput
+ *   Checks the first BINARYSAMPLE bytes of the standard output for binary data: control
+ *   characters not used in text or, for UTF-8, invalid sequences. Binary output isn't
+ *   inserted into the document; a hex dump of its start is displayed and the bytes are
+ *   written to a temporary file, which the built in command save copies.
+ * @param job
+ * @param data  block read from the standard output
+ * @return true = the block is binary output and isn't decoded
+ */
+bool TerminalWindow::binaryOutput(Job *job, const QByteArray &data)
+{
+    if (!job->binary) {
+        if (job->sampled >= BINARYSAMPLE) return false;
+
+        qsizetype size = qMin((qsizetype)data.size(),(qsizetype)(BINARYSAMPLE-job->sampled));
+
+        OutputDecoder::sampleBytes(data.constData(),size,encoding == OutputDecoder::UTF8,job->sampleControls,job->sampleInvalid);
+        job->sampled+= size;
+
+        if (job->sampled < BINARYMINIMUM ||
+           (job->sampleControls*100 <= job->sampled*BINARYCONTROLS && job->sampleInvalid*100 <= job->sampled*BINARYINVALID)) {
+            // Output is text? => the checked bytes are kept for the spool file until the check is finished
+            if (job->sampled < BINARYSAMPLE) {
+                job->head+= data;
+            } else {
+                job->head.clear();
+            }
+            return false;
+        }
+
+        job->binary = true;
+        job->head+= data;
+        job->binaryBytes = job->head.size();
+
+        // binary output isn't cached
+        job->cacheKey.clear();
+        job->capture.clear();
+
+        job->spool = new QTemporaryFile(QDir::tempPath()+"/cmdlib-XXXXXX.bin",this);
+        if (job->spool->open()) {
+            job->spool->write(job->head);
+        } else {
+            delete job->spool;
+            job->spool = nullptr;
+        }
+
+        // hex dump of the start of the output; 16 bytes per line with offset and characters
+        QString dump;
+        int     previewSize = qMin((int)job->head.size(),BINARYPREVIEW);
+
+        for (int pos = 0; pos < previewSize; pos+= 16) {
+            QString chars;
+            dump+= QString("%1 ").arg(pos,8,16,QChar('0'));
+            for (int num = 0; num < 16; num++) {
+                if (num == 8) dump+= ' ';
+                if (pos+num < previewSize) {
+                    uchar chr = (uchar)job->head.at(pos+num);
+                    dump+= QString(" %1").arg(chr,2,16,QChar('0'));
+                    chars+= (chr >= 0x20 && chr < 0x7f) ? QChar(chr) : QChar('.');
+                } else {
+                    dump+= "   ";
+                }
+            }
+            dump+= "  |"+chars+"|\n";
+        }
+
+        job->head.clear();
+
+        if (!job->output.isEmpty() && !job->output.endsWith('\n')) job->output+= '\n';
+        job->output+= ANSIRESET "["+tr("Binary output")+"]\n"+dump;
+        job->lineStart = true;
+
+        if (sessionLog != nullptr) sessionLog->output(job->id,QProcess::StandardOutput,"["+tr("Binary output")+"]\n");
+
+        if (!flushTimer->isActive()) {
+            flushTimer->start();
+        }
+
+        return true;
+    }
+
+    job->binaryBytes+= data.size();
+
+    if (job->spool != nullptr) job->spool->write(data);
+
+    return true;
+}
+
+/**
+ * @brief TerminalWindow::binarySummary
+ *   Appends the number of bytes of a finished job's binary output.
+ * @param job
+ */
+void TerminalWindow::binarySummary(Job *job)
+{
+    QString summary;
+
+    if (!job->binary) return;
+
+    if (job->spool != nullptr) {
+        job->spool->flush();
+        summary = tr("%1 bytes of binary output; save <file> writes them to a file").arg(job->binaryBytes);
+    } else {
+        summary = tr("%1 bytes of binary output; could not create a temporary file").arg(job->binaryBytes);
+    }
+
+    if (!job->output.isEmpty() && !job->output.endsWith('\n')) job->output+= '\n';
+    job->output+= ANSIRESET "["+summary+"]\n";
+
+    if (sessionLog != nullptr) sessionLog->output(job->id,QProcess::StandardOutput,"["+summary+"]\n");
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::captureOutput
+ *   Keeps the output of a cacheable job for the result cache. Outputs larger than
+ *   CACHEMAXENTRY characters aren't cached.
+ * @param job
+ * @param text
+ */
+void TerminalWindow::captureOutput(Job *job, const QString &text)
+{
+    if (job->cacheKey.isEmpty()) return;
+
+    job->capture+= text;
+
+    if (job->capture.size() > CACHEMAXENTRY) {
+        job->cacheKey.clear();
+        job->capture.clear();
+    }
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::cacheJob
+ *   Stores the output of a finished cacheable job; only successful runs are cached.
+ * @param job
+ */
+void TerminalWindow::cacheJob(Job *job)
+{
+    if (cache == nullptr || job->cacheKey.isEmpty()) return;
+
+    if (job->exitStatus == QProcess::NormalExit && job->exitCode == 0 && !job->timedOut) {
+        cache->store(job->cacheKey,job->capture,job->exitCode);
+    }
+
+    job->capture.clear();
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::replayCached
+ *   Displays a cached output as output of a finished foreground job. A marker tells the age
+ *   of the output and how to execute the command again.
+ * @param output
+ * @param exitCode
+ * @param age  age of the output in seconds
+ */
+void TerminalWindow::replayCached(const QString &output, int exitCode, qint64 age)
+{
+    Job *job = new Job;
+
+    job->id         = nextJobId();
+    job->cmdLine    = lineEntered.trimmed();
+    job->background = false;
+    job->finished   = true;
+    job->exitCode   = exitCode;
+    job->output     = output;
+
+    if (!job->output.isEmpty() && !job->output.endsWith('\n')) job->output+= '\n';
+
+    job->output+= ANSIRESET "["+tr("cached")+", "+QString::number(age)+" s "+tr("old")+"; "+tr("Shift+Return executes the command again")+"]\n";
+
+    jobs.append(job);
+    fgJob = job;
+
+    if (!flushTimer->isActive()) {
+        flushTimer->start();
+    }
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::setProfile
+ *   Sets the aggregates the durations of the executed commands are added to.
+ * @param prof
+ * @param display  true = the resource usage is displayed after a command
+ */
+void TerminalWindow::setProfile(CmdProfile *prof, bool display)
+{
+    profile    = prof;
+    dspProfile = display;
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::profileJob
+ *   Determines the resource usage of a finished job and adds the duration to the profile.
+ *   The CPU time is the difference of the resource usage of the terminated child processes;
+ *   if other processes terminated while the job was running, the time is marked with a tilde.
+ * @param job
+ * @return resource usage as text
+ */
+QString TerminalWindow::profileJob(Job *job)
+{
+    double  real = job->wallTimer.nsecsElapsed() / 1e9;
+    QString text = "real "+QString::number(real,'f',3)+"s";
+
+  #ifdef Q_OS_UNIX
+    // The commands of the persistent shell are children of the shell, their usage isn't available.
+    if (job->session == nullptr) {
+        struct rusage usage;
+
+        getrusage(RUSAGE_CHILDREN,&usage);
+
+        double user = (usage.ru_utime.tv_sec - job->usageStart.ru_utime.tv_sec) +
+                      (usage.ru_utime.tv_usec - job->usageStart.ru_utime.tv_usec) / 1e6;
+        double sys  = (usage.ru_stime.tv_sec - job->usageStart.ru_stime.tv_sec) +
+                      (usage.ru_stime.tv_usec - job->usageStart.ru_stime.tv_usec) / 1e6;
+        long maxRss = usage.ru_maxrss;
+      #ifdef Q_OS_MACOS
+        maxRss/= 1024;  // the maximum resident set size is counted in bytes
+      #endif
+
+        // A new maximum of the terminated child processes? => the maximum is caused by the job
+        if (usage.ru_maxrss > job->usageStart.ru_maxrss && maxRss > job->peakRss) job->peakRss = maxRss;
+
+        QString approx = (procsFinished - job->procsFinishedStart != job->procsFinished) ? "~" : "";
+
+        text+= "  user "+approx+QString::number(user,'f',3)+"s";
+        text+= "  sys "+approx+QString::number(sys,'f',3)+"s";
+    }
+  #endif
+
+    if (job->peakRss > 0) {
+        text+= "  max rss "+QString::number(job->peakRss/1024.0,'f',1)+" MB";
+    }
+
+    if (profile != nullptr && !job->entered.isEmpty()) {
+        profile->add(job->entered.toStdString(),real);
+        emit commandProfiled_signal();
+    }
+
+    // the end of the job is logged with its resource usage
+    if (sessionLog != nullptr) {
+        sessionLog->finished(job->id,job->exitStatus == QProcess::NormalExit ? job->exitCode : -1,job->cmdLine+"  ["+text+"]");
+    }
+
+    return text;
+}
+
+/**
+ * @brief TerminalWindow::sampleJobs
+ *   Samples the peak resident set size of the running processes from /proc. The processes
+ *   of a pipeline run at the same time, so their sizes are added.
+ */
+void TerminalWindow::sampleJobs()
+{
+  #ifdef Q_OS_LINUX
+    bool running = false;
+    QList<qint64> pids;
+
+    for (int idx = 0; idx < jobs.size(); idx++) {
+        Job *job = jobs.at(idx);
+        long sum = 0;
+
+        if (job->finished) continue;
+
+        pids.clear();
+
+        for (int num = 0; num < job->stages.size(); num++) {
+            if (job->stages.at(num)->state() == QProcess::NotRunning) continue;
+            running = true;
+            if (job->stages.at(num)->state() == QProcess::Running) pids << job->stages.at(num)->processId();
+        }
+
+        if (job->pty != nullptr && job->pty->isRunning()) {
+            running = true;
+            pids << job->pty->processId();
+        }
+
+        for (int num = 0; num < pids.size(); num++) {
+            QFile status("/proc/"+QString::number(pids.at(num))+"/status");
+
+            if (status.open(QIODevice::ReadOnly)) {
+                QByteArray data = status.readAll();
+                int pos = data.indexOf("VmHWM:");
+                if (pos >= 0) {
+                    int end = data.indexOf('\n',pos);
+                    sum+= data.mid(pos+6,end-pos-6).replace("kB","").trimmed().toLong();
+                }
+                status.close();
+            }
+        }
+
+        if (sum > job->peakRss) job->peakRss = sum;
+    }
+
+    if (!running) sampleTimer->stop();
+  #endif
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::setHistory
+ *   Sets the history used for Up/Down and the reverse search with Ctrl-R.
+ * @param hist
+ */
+void TerminalWindow::setHistory(CmdHistory *hist)
+{
+    history = hist;
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::getCommandLine
+ * @return line entered after the prompt
+ */
+QString TerminalWindow::getCommandLine()
+{
+    QTextCursor cursor(document());
+
+    cursor.setPosition(cmdLineStart);
+    cursor.movePosition(QTextCursor::End,QTextCursor::KeepAnchor);
+
+    return cursor.selectedText();
+}
+
+/**
+ * @brief TerminalWindow::setCommandLine
+ *   Replaces the line entered after the prompt.
+ * @param line
+ */
+void TerminalWindow::setCommandLine(const QString &line)
+{
+    currCursor = textCursor();
+
+    currCursor.setPosition(cmdLineStart);
+    currCursor.movePosition(QTextCursor::End,QTextCursor::KeepAnchor);
+    currCursor.insertText(line);
+
+    setTextCursor(currCursor);
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::completeLine
+ *   Completes the word in front of the cursor. The first word of a command is completed
+ *   from the executables of PATH, other words from the entries of the directory. If the
+ *   word can't be extended, the possible completions are displayed.
+ */
+void TerminalWindow::completeLine()
+{
+    int         wordStart;
+    bool        isCommand;
+    QString     before;
+    QString     word;
+    QString     head;
+    QString     common;
+    QString     insert;
+    QStringList matches;
+
+    currCursor = textCursor();
+
+    before    = getCommandLine().left(currCursor.position() - cmdLineStart);
+    wordStart = before.lastIndexOf(' ') + 1;
+    word      = before.mid(wordStart);
+    head      = before.left(wordStart).trimmed();
+
+    // first word of the command line or of a pipeline stage?
+    isCommand = head.isEmpty() || head.endsWith('|') || head.endsWith('&');
+
+    if (isCommand && !word.contains('/') && !word.isEmpty()) {
+        matches = pathIndex->complete(word);
+    } else {
+        matches = completePath(word);
+    }
+
+    if (matches.isEmpty()) return;
+
+    // longest common prefix of the completions
+    common = matches.first();
+    for (int idx = 1; idx < matches.size() && common.size() > word.size(); idx++) {
+        int len = 0;
+        while (len < common.size() && len < matches.at(idx).size() && common.at(len) == matches.at(idx).at(len)) len++;
+        common.truncate(len);
+    }
+
+    insert = common.mid(word.size());
+
+    // Unique completion? => the word is finished, a directory may be continued
+    if (matches.size() == 1 && !common.endsWith('/')) insert+= ' ';
+
+    if (!insert.isEmpty()) {
+        currCursor.insertText(insert);
+        setTextCursor(currCursor);
+    } else if (matches.size() > 1) {
+        displayCompletions(matches);
+    }
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::completePath
+ *   Determines the entries of a directory starting with the last part of a word. Reading
+ *   the directory is stopped after COMPLETIONTIME ms, so huge directories don't block
+ *   the terminal window.
+ * @param word  relative or absolute path
+ * @return sorted completions of the word; directories end with a slash
+ */
+QStringList TerminalWindow::completePath(const QString &word)
+{
+    int           slash    = word.lastIndexOf('/');
+    QString       dirPart  = word.left(slash+1);
+    QString       namePart = word.mid(slash+1);
+    QString       dirPath  = dirPart;
+    QString       name;
+    QStringList   matches;
+    QElapsedTimer timer;
+    QDir::Filters filters  = QDir::AllEntries|QDir::NoDotAndDotDot;
+  #ifdef Q_OS_WIN
+    Qt::CaseSensitivity cs = Qt::CaseInsensitive;
+  #else
+    Qt::CaseSensitivity cs = Qt::CaseSensitive;
+  #endif
+
+    // the tilde is replaced by the home directory when the command is executed
+    if (dirPath.startsWith('~')) dirPath.replace(0,1,homeDir);
+
+    if (namePart.startsWith('.')) filters|= QDir::Hidden;
+
+    QDirIterator iter(dirPath.isEmpty() ? workDir->absolutePath() : workDir->absoluteFilePath(dirPath),filters);
+
+    timer.start();
+
+    while (iter.hasNext() && timer.elapsed() < COMPLETIONTIME) {
+        iter.next();
+        name = iter.fileName();
+        if (!name.startsWith(namePart,cs)) continue;
+        if (iter.fileInfo().isDir()) name+= '/';
+        // the completion keeps the entered part of the word
+        matches << dirPart + namePart + name.mid(namePart.size());
+    }
+
+    matches.sort(cs);
+
+    return matches;
+}
+
+/**
+ * @brief TerminalWindow::displayCompletions
+ *   Displays the possible completions below the command line and a new prompt with the
+ *   entered line.
+ * @param matches
+ */
+void TerminalWindow::displayCompletions(const QStringList &matches)
+{
+    QString line   = getCommandLine();
+    int     offset = textCursor().position() - cmdLineStart;
+    QString list;
+    QString name;
+
+    for (int idx = 0; idx < matches.size() && idx < COMPLETIONLIST; idx++) {
+        // only the last part of a path is displayed
+        name = matches.at(idx);
+        name = name.mid(name.lastIndexOf('/',-2)+1);
+        list+= name + "  ";
+    }
+
+    if (matches.size() > COMPLETIONLIST) {
+        list+= "... (" + QString::number(matches.size()-COMPLETIONLIST) + ")";
+    }
+
+    currCursor = textCursor();
+    currCursor.movePosition(QTextCursor::End);
+    currCursor.insertText("\n" + list + "\ncmd$ ");
 
-    currCursor.insertText("cmd$ ");
     cmdLineStart = currCursor.position();
     cmdLineEnd   = cmdLineStart;
 
-    setTextCursor(currCursor);
+    currCursor.insertText(line);
+    currCursor.setPosition(cmdLineStart+offset);
+    setTextCursor(currCursor);
+
+    scrollToEnd();
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::historyUp
+ *   Displays the previous command of the history starting with the line entered
+ *   before the first Up. Commands equal to the displayed line are skipped.
+ */
+void TerminalWindow::historyUp()
+{
+    int     num;
+    QString line = getCommandLine();
+
+    if (histPos < 0) {
+        histPrefix = line;
+        histPos    = history->size();
+    }
+
+    num = histPos;
+    do {
+        num = history->findPrefix(histPrefix.toStdString(),num);
+    } while (num >= 0 && QString::fromStdString(history->at(num)) == line);
+
+    if (num >= 0) {
+        histPos = num;
+        setCommandLine(QString::fromStdString(history->at(num)));
+    }
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::historyDown
+ *   Displays the next command of the history starting with the line entered before
+ *   the first Up. After the newest command the entered line is displayed again.
+ */
+void TerminalWindow::historyDown()
+{
+    int     num;
+    QString line = getCommandLine();
+
+    if (histPos < 0) return;
+
+    num = histPos;
+    do {
+        num = history->findPrefix(histPrefix.toStdString(),num,false);
+    } while (num >= 0 && QString::fromStdString(history->at(num)) == line);
+
+    if (num >= 0) {
+        histPos = num;
+        setCommandLine(QString::fromStdString(history->at(num)));
+    } else {
+        histPos = -1;
+        setCommandLine(histPrefix);
+    }
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::searchKeyPressed
+ *   Handles the keys pressed during the reverse search. Characters extend the searched
+ *   text, Ctrl-R searches an older command, Escape restores the line entered before
+ *   the search. Return and the cursor keys take over the found command.
+ * @param event
+ * @return true = the key is processed as usual after the search
+ */
+bool TerminalWindow::searchKeyPressed(QKeyEvent *event)
+{
+    if (event->key() == Qt::Key_R && (event->modifiers() & Qt::ControlModifier)) {
+        searchHistory(searchPos);
+        return false;
+    }
+
+    switch (event->key()) {
+        case Qt::Key_Escape:
+            endSearch(false);
+            return false;
+        case Qt::Key_Backspace:
+            // search the shorter text again starting with the newest command
+            searchText.chop(1);
+            searchHistory(history->size());
+            return false;
+        case Qt::Key_Return:
+        case Qt::Key_Enter:
+        case Qt::Key_Left:
+        case Qt::Key_Right:
+        case Qt::Key_Up:
+        case Qt::Key_Down:
+        case Qt::Key_Home:
+        case Qt::Key_End:
+        case Qt::Key_Tab:
+            endSearch(true);
+            return true;
+        default:
+            break;
+    }
+
+    if (!event->text().isEmpty() && event->text().at(0).isPrint()) {
+        // the found command is checked again, it may contain the extended text too
+        searchText+= event->text();
+        searchHistory((searchPos >= 0) ? searchPos+1 : history->size());
+    }
+
+    return false;
+}
+
+/**
+ * @brief TerminalWindow::searchHistory
+ *   Searches the newest command before a number containing the searched text and
+ *   displays the search in the command line. If no command is found, the previously
+ *   found command remains.
+ * @param start  number of the command the search starts before
+ */
+void TerminalWindow::searchHistory(int start)
+{
+    int     num = -1;
+    QString found;
+
+    if (!searchText.isEmpty()) {
+        num = history->findText(searchText.toStdString(),start);
+        if (num >= 0) searchPos = num;
+    } else {
+        searchPos = -1;
+    }
+
+    if (searchPos >= 0) found = QString::fromStdString(history->at(searchPos));
+
+    setCommandLine(QString((num < 0 && !searchText.isEmpty()) ? "(failed reverse-i-search)`" : "(reverse-i-search)`")
+                   + searchText + "': " + found);
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::endSearch
+ *   Finishes the reverse search.
+ * @param accept  true = the found command is the entered line; false = the line entered before the search is restored
+ */
+void TerminalWindow::endSearch(bool accept)
+{
+    searchMode = false;
+    histPos    = -1;
+
+    if (accept && searchPos >= 0) {
+        setCommandLine(QString::fromStdString(history->at(searchPos)));
+    } else {
+        setCommandLine(searchLine);
+    }
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::syncIndex
+ *   Copies the blocks appended to the document since the last call to the index of the
+ *   scrollback. The document is only changed at its end apart from trimming and clearing,
+ *   which adjust the index themselves. The last block is the prompt or the line still
+ *   written by the foreground job, so it isn't copied. The lines are stored in lower case
+ *   for the search ignoring the case.
+ */
+void TerminalWindow::syncIndex()
+{
+    QTextDocument *doc = document();
+
+    int last = doc->blockCount() - 1;
+
+    if (indexedBlocks > last) {
+        scrollIndex->truncate(last);
+        indexedBlocks = last;
+    }
+
+    if (indexedBlocks == last) return;
+
+    QTextBlock block = doc->findBlockByNumber(indexedBlocks);
+
+    while (block.isValid() && indexedBlocks < last) {
+        scrollIndex->appendLine(block.text().toLower().toStdString());
+        block = block.next();
+        indexedBlocks++;
+    }
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::findBlockWith
+ *   Searches the next block containing the searched text. The indexed blocks are scanned in
+ *   the index; the last block isn't indexed and is compared directly.
+ * @param start     number of the block the search starts at; the block itself isn't searched
+ * @param backward  true = search the previous blocks; false = search the following blocks
+ * @return number of the block; -1 = not found
+ */
+int TerminalWindow::findBlockWith(int start, bool backward)
+{
+    string needle = findText.toLower().toStdString();
+    int    last   = document()->blockCount() - 1;
+    bool   inLast = document()->lastBlock().text().contains(findText,Qt::CaseInsensitive);
+
+    if (backward) {
+        if (start > last && inLast) return last;
+        return (int)scrollIndex->findLine(needle,qMin(start,indexedBlocks),true);
+    }
+
+    long line = scrollIndex->findLine(needle,start,false);
+
+    if (line < 0 && start < last && inLast) return last;
+
+    return (int)line;
+}
+
+/**
+ * @brief TerminalWindow::findHit
+ *   Moves to the next hit of the searched text and scrolls the hit into the middle of the
+ *   window. The search continues at the other end of the scrollback.
+ * @param backward  true = previous hit; false = next hit
+ */
+void TerminalWindow::findHit(bool backward)
+{
+    QTextBlock block;
+    QString    text;
+    int        column = -1;
+    int        num;
+
+    if (findText.isEmpty()) return;
+
+    syncIndex();
+
+    // another hit in the block of the current hit?
+    if (findBlock >= 0) {
+        block = document()->findBlockByNumber(findBlock);
+        if (block.isValid()) {
+            text = block.text();
+            if (backward) {
+                if (findColumn > 0) column = text.lastIndexOf(findText,findColumn-1,Qt::CaseInsensitive);
+            } else {
+                column = text.indexOf(findText,findColumn+1,Qt::CaseInsensitive);
+            }
+        }
+    }
+
+    if (column < 0) {
+        num = findBlockWith(findBlock,backward);
+        if (num < 0) num = findBlockWith(backward ? document()->blockCount() : -1,backward);
+
+        if (num < 0) {
+            findBlock  = -1;
+            findColumn = -1;
+            highlightHits();
+            return;
+        }
+
+        text   = document()->findBlockByNumber(num).text();
+        column = backward ? text.lastIndexOf(findText,-1,Qt::CaseInsensitive) : text.indexOf(findText,0,Qt::CaseInsensitive);
+
+        // The lower case of a character differs from the comparison ignoring the case? => the line is marked at its start
+        if (column < 0) column = 0;
+
+        findBlock = num;
+    }
+
+    findColumn = column;
+
+    // the scroll bar of QPlainTextEdit counts blocks
+    int rows = viewport()->height() / qMax(fontMetrics().height(),1);
+
+    verticalScrollBar()->setValue(qMax(findBlock - rows/2,0));
+
+    highlightHits();
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::highlightHits
+ *   Highlights the hits in the visible blocks; the current hit is highlighted differently.
+ *   Only the visible blocks are searched, so the highlighting is independent of the size
+ *   of the scrollback. The slot is called if the window is scrolled.
+ */
+void TerminalWindow::highlightHits()
+{
+    QList<QTextEdit::ExtraSelection> selections;
+
+    if (findBar->isHidden() || findText.isEmpty()) {
+        setExtraSelections(selections);
+        return;
+    }
+
+    QTextCharFormat hitFormat;
+    QTextCharFormat currFormat;
+
+    hitFormat.setBackground(QColor(255,235,120));
+    hitFormat.setForeground(Qt::black);
+    currFormat.setBackground(QColor(255,150,50));
+    currFormat.setForeground(Qt::black);
+
+    QTextBlock block  = firstVisibleBlock();
+    int        bottom = viewport()->height();
+
+    while (block.isValid() && blockBoundingGeometry(block).translated(contentOffset()).top() <= bottom) {
+        QString text   = block.text();
+        int     column = text.indexOf(findText,0,Qt::CaseInsensitive);
+        while (column >= 0) {
+            QTextEdit::ExtraSelection selection;
+            selection.cursor = QTextCursor(document());
+            selection.cursor.setPosition(block.position()+column);
+            selection.cursor.setPosition(block.position()+column+findText.size(),QTextCursor::KeepAnchor);
+            selection.format = (block.blockNumber() == findBlock && column == findColumn) ? currFormat : hitFormat;
+            selections << selection;
+            column = text.indexOf(findText,column+findText.size(),Qt::CaseInsensitive);
+        }
+        block = block.next();
+    }
+
+    setExtraSelections(selections);
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::findChanged
+ *   The searched text was edited. The search starts again at the newest output.
+ * @param text
+ */
+void TerminalWindow::findChanged(QString text)
+{
+    findText   = text;
+    findBlock  = -1;
+    findColumn = -1;
+
+    findBar->setHits(-1);
+
+    if (findText.isEmpty()) {
+        countTimer->stop();
+        highlightHits();
+        return;
+    }
+
+    findHit(true);
+
+    // counting all hits takes longer than finding the first hit => the hits are counted after the input paused
+    countTimer->start();
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::findNext
+ */
+void TerminalWindow::findNext()
+{
+    findHit(false);
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::findPrevious
+ */
+void TerminalWindow::findPrevious()
+{
+    findHit(true);
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::findClosed
+ *   Closes the find bar and removes the highlighting; the input returns to the command line.
+ */
+void TerminalWindow::findClosed()
+{
+    countTimer->stop();
+
+    findBar->hide();
+    findBlock  = -1;
+    findColumn = -1;
+
+    highlightHits();
+
+    setFocus();
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::countHits
+ *   Counts the hits of the searched text in the whole scrollback.
+ */
+void TerminalWindow::countHits()
+{
+    if (findBar->isHidden() || findText.isEmpty()) return;
+
+    syncIndex();
+
+    size_t hits = scrollIndex->count(findText.toLower().toStdString());
+
+    hits+= document()->lastBlock().text().count(findText,Qt::CaseInsensitive);
+
+    findBar->setHits((int)hits);
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::placeFindBar
+ *   Places the find bar in the upper right corner of the visible text.
+ */
+void TerminalWindow::placeFindBar()
+{
+    QRect area = viewport()->geometry();
+
+    findBar->adjustSize();
+    findBar->move(qMax(area.right() - findBar->width() - 4,area.left()),area.top() + 4);
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::startWatch
+ *   Starts executing a command repeatedly. The output of the command is displayed below a
+ *   header line and replaced by the output of the next run, so the scrollback doesn't grow.
+ * @param command
+ * @param interval  time between the end of a run and the start of the next run in ms
+ */
+void TerminalWindow::startWatch(const QString &command, int interval)
+{
+    watching      = true;
+    watchCommand  = command;
+    watchInterval = interval;
+    watchRuns     = 0;
+
+    watchLines.clear();
+    watchMarked.clear();
+
+    currCursor.movePosition(QTextCursor::End);
+
+    int headerPos = currCursor.position();
+
+    currCursor.insertText(tr("Every %1 s: %2").arg(interval/1000.0).arg(command)+"\n",plainFormat);
+
+    // a cursor at the header follows the text inserted before it
+    watchHeader = QTextCursor(document());
+    watchHeader.setPosition(headerPos);
+
+    runWatch();
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::runWatch
+ *   Executes the watched command once; the output is displayed when the command finished.
+ */
+void TerminalWindow::runWatch()
+{
+    if (!watching || watchProcess != nullptr) return;
+
+    watchProcess = new LimitedProcess(this);
+
+    watchProcess->setWorkingDirectory(workDir->absolutePath());
+    watchProcess->setProcessChannelMode(QProcess::MergedChannels);
+    watchProcess->setLimits(limits);
+
+    connect(watchProcess,SIGNAL(finished(int,QProcess::ExitStatus)),this,SLOT(watchFinished(int,QProcess::ExitStatus)));
+    connect(watchProcess,SIGNAL(errorOccurred(QProcess::ProcessError)),this,SLOT(watchError(QProcess::ProcessError)));
+    connect(watchProcess,SIGNAL(timedOut_signal()),watchProcess,SLOT(kill()));
+
+  #ifdef Q_OS_WIN
+    watchProcess->start("cmd",QStringList() << "/C" << watchCommand);
+  #else
+    watchProcess->start("/bin/sh",QStringList() << "-c" << watchCommand);
+  #endif
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::watchFinished
+ *   Displays the output of a run of the watched command and starts the interval to the next run.
+ * @param exitCode
+ * @param exitStatus
+ */
+void TerminalWindow::watchFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    if (sender() != watchProcess) return;
+
+    OutputDecoder decoder(encoding);
+
+    QString text = decoder.decode(watchProcess->readAll());
+
+    watchProcess->disconnect(this);
+    watchProcess->deleteLater();
+    watchProcess = nullptr;
+
+    // the escape sequences are removed; the changes are highlighted instead
+    AnsiParser parser(plainFormat);
+    QString plain;
+
+    const QList<AnsiParser::Run> &runs = parser.parse(text);
+
+    for (int idx = 0; idx < runs.size(); idx++) {
+        plain+= text.mid(runs.at(idx).start,runs.at(idx).length);
+    }
+
+    QStringList lines = plain.split('\n');
+
+    if (!lines.isEmpty() && lines.last().isEmpty()) lines.removeLast();
+
+    for (int idx = 0; idx < lines.size(); idx++) {
+        if (lines.at(idx).endsWith('\r')) lines[idx].chop(1);
+    }
+
+    QString status = (exitStatus == QProcess::NormalExit) ? tr("exit")+" "+QString::number(exitCode) : tr("terminated");
+
+    applyWatchOutput(lines,status);
+
+    if (watching) watchTimer->start(watchInterval);
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::watchError
+ *   A command not started doesn't emit finished(); the next run is tried after the interval.
+ * @param error
+ */
+void TerminalWindow::watchError(QProcess::ProcessError error)
+{
+    if (sender() != watchProcess || error != QProcess::FailedToStart) return;
+
+    watchProcess->disconnect(this);
+    watchProcess->deleteLater();
+    watchProcess = nullptr;
+
+    applyWatchOutput(QStringList(),tr("failed to start"));
+
+    if (watching) watchTimer->start(watchInterval);
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::applyWatchOutput
+ *   Replaces the output of the previous run by the output of the current run in place. Only
+ *   the lines differing between the runs are edited: an O(ND) diff on hashes of the lines
+ *   determines the deleted and inserted lines. Inserted lines are highlighted, the highlight
+ *   of the previous run is removed. The header shows the time and the exit status of the run.
+ * @param lines   output of the run
+ * @param status  exit status of the run
+ */
+void TerminalWindow::applyWatchOutput(const QStringList &lines, const QString &status)
+{
+    vector<uint64_t> oldHashes;
+    vector<uint64_t> newHashes;
+    QList<bool>      marked;
+    int oldIdx   = 0;
+    int newIdx   = 0;
+    int inserted = 0;
+    int deleted  = 0;
+
+    // FNV-1a hashes of the lines
+    for (int idx = 0; idx < watchLines.size() + lines.size(); idx++) {
+        const QString &line = (idx < watchLines.size()) ? watchLines.at(idx) : lines.at(idx-watchLines.size());
+        uint64_t hash = 14695981039346656037ull;
+        for (int pos = 0; pos < line.size(); pos++) {
+            hash = (hash ^ line.at(pos).unicode()) * 1099511628211ull;
+        }
+        if (idx < watchLines.size()) oldHashes.push_back(hash); else newHashes.push_back(hash);
+    }
+
+    vector<LineDiff::Edit> edits = LineDiff::compute(oldHashes,newHashes);
+
+    QTextCharFormat changedFormat = plainFormat;
+
+    changedFormat.setBackground(QColor(255,235,120));
+
+    int headerPos = watchHeader.position();
+
+    QTextCursor cursor(document());
+
+    beginEdit();
+
+    QTextBlock block = document()->findBlock(headerPos).next();
+
+    // the lines of the output are edited => the index of the scrollback is updated from here
+    if (indexedBlocks > block.blockNumber()) {
+        scrollIndex->truncate(block.blockNumber());
+        indexedBlocks = block.blockNumber();
+    }
+
+    for (size_t num = 0; num < edits.size(); num++) {
+        for (int cntr = 0; cntr < edits[num].count; cntr++) {
+            switch (edits[num].op) {
+                case LineDiff::EQUAL:
+                    if (watchMarked.at(oldIdx)) {
+                        cursor.setPosition(block.position());
+                        cursor.movePosition(QTextCursor::EndOfBlock,QTextCursor::KeepAnchor);
+                        cursor.setCharFormat(plainFormat);
+                    }
+                    marked << false;
+                    block = block.next();
+                    oldIdx++;
+                    newIdx++;
+                    break;
+                case LineDiff::DELETE: {
+                    int pos = block.position();
+                    cursor.setPosition(pos);
+                    cursor.setPosition(block.next().position(),QTextCursor::KeepAnchor);
+                    cursor.removeSelectedText();
+                    block = document()->findBlock(pos);
+                    oldIdx++;
+                    deleted++; }
+                    break;
+                case LineDiff::INSERT:
+                    // the first output isn't highlighted
+                    cursor.setPosition(block.position());
+                    cursor.insertText(lines.at(newIdx)+"\n",watchRuns > 0 ? changedFormat : plainFormat);
+                    marked << (watchRuns > 0);
+                    block = cursor.block();
+                    newIdx++;
+                    inserted++;
+                    break;
+            }
+        }
+    }
+
+    // header with the time and the exit status of the run and the number of changed lines
+    QString header = tr("Every %1 s: %2").arg(watchInterval/1000.0).arg(watchCommand)+"   "+
+                     QTime::currentTime().toString("hh:mm:ss")+"   "+status;
+
+    if (watchRuns > 0) header+= "   +"+QString::number(inserted)+" -"+QString::number(deleted);
+
+    header+= "   ("+tr("Ctrl-C stops")+")";
+
+    cursor.setPosition(headerPos);
+    cursor.movePosition(QTextCursor::EndOfBlock,QTextCursor::KeepAnchor);
+    cursor.insertText(header,plainFormat);
+
+    endEdit();
+
+    watchHeader.setPosition(headerPos);
+
+    watchLines  = lines;
+    watchMarked = marked;
+
+    if (watchRuns == 0) scrollToEnd();
+
+    watchRuns++;
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::stopWatch
+ *   Stops executing the watched command; the output of the last run is kept.
+ */
+void TerminalWindow::stopWatch()
+{
+    if (!watching) return;
+
+    watching = false;
+
+    watchTimer->stop();
+
+    if (watchProcess != nullptr) {
+        watchProcess->disconnect(this);
+        watchProcess->kill();
+        watchProcess->deleteLater();
+        watchProcess = nullptr;
+    }
+
+    // the highlight of the last changes is removed
+    QTextCursor cursor(document());
+    QTextBlock  block = document()->findBlock(watchHeader.position()).next();
+
+    beginEdit();
+
+    for (int idx = 0; idx < watchMarked.size() && block.isValid(); idx++) {
+        if (watchMarked.at(idx)) {
+            cursor.setPosition(block.position());
+            cursor.movePosition(QTextCursor::EndOfBlock,QTextCursor::KeepAnchor);
+            cursor.setCharFormat(plainFormat);
+        }
+        block = block.next();
+    }
+
+    cursor.movePosition(QTextCursor::End);
+    cursor.insertText("cmd$ ",plainFormat);
+
+    endEdit();
+
+    watchLines.clear();
+    watchMarked.clear();
+
+    cmdLineStart = cursor.position();
+    cmdLineEnd   = cmdLineStart;
+
+    setTextCursor(cursor);
+    scrollToEnd();
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::trimScrollback
+ *   Removes the oldest lines of the document if the scrollback limits are exceeded.
+ *   The lines are removed at once, if a limit is exceeded by a tenth, so the costs
+ *   for removing lines are spread over the inserted output. The line containing the
+ *   prompt is never removed; a line exceeding the character limit on its own is cut
+ *   at its start.
+ * @param cursor  cursor of the edit block the scrollback is trimmed in
+ */
+void TerminalWindow::trimScrollback(QTextCursor &cursor)
+{
+    int removeBlocks = 0;
+    int removeChars  = 0;
+
+    QTextDocument *doc = document();
+
+    int blocks = doc->blockCount();
+    int chars  = doc->characterCount();
+
+    if (scrollbackLines > 0 && blocks > scrollbackLines + scrollbackLines/10) {
+        removeBlocks = blocks - scrollbackLines;
+    }
+
+    if (scrollbackChars > 0 && chars > scrollbackChars + scrollbackChars/10) {
+        removeChars = chars - scrollbackChars;
+    }
+
+    if (removeBlocks == 0 && removeChars == 0) return;
+
+    // determine the first line to keep
+    QTextBlock block = doc->begin();
+    int cntr = 0;
+
+    while (block.isValid() && block != doc->lastBlock() &&
+           (cntr < removeBlocks || block.position() < removeChars)) {
+        block = block.next();
+        cntr++;
+    }
+
+    int removeEnd = block.position();
+    int cutChars  = 0;
+
+    // Line kept still exceeding the limit, e.g. output without new lines? => its oldest
+    // characters are cut, but not the prompt or the command line
+    if (removeEnd < removeChars && (block != doc->lastBlock() || fgJob != nullptr)) {
+        cutChars = qMin(removeChars - removeEnd,block.length() - 1);
+        cutChars = qMin(cutChars,cmdLineStart - removeEnd);
+        if (cutChars < 0) cutChars = 0;
+    }
+
+    if (removeEnd + cutChars <= 0) return;
+
+    // remove the oldest lines as one range
+    QTextCursor trimCursor(doc);
+    trimCursor.setPosition(0);
+    trimCursor.setPosition(removeEnd + cutChars,QTextCursor::KeepAnchor);
+    trimCursor.removeSelectedText();
+
+    cmdLineStart-= removeEnd + cutChars;
+    cmdLineEnd  -= removeEnd + cutChars;
+
+    // the removed blocks are removed from the index of the scrollback, too
+    scrollIndex->removeFirstLines(cntr);
+    indexedBlocks = qMax(indexedBlocks - cntr,0);
+    findBlock     = (findBlock >= cntr) ? findBlock - cntr : -1;
+
+    // Cut line already in the index? => only this line of the index is replaced
+    if (cutChars > 0 && indexedBlocks > 0) {
+        scrollIndex->replaceFirstLine(doc->begin().text().toLower().toStdString());
+    }
+
+    if (cmdLineStart < 0) cmdLineStart = 0;
+    if (cmdLineEnd < 0)   cmdLineEnd   = 0;
+
+    cursor.movePosition(QTextCursor::End);
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::beginEdit
+ *   Starts a batch of changes of the document. Batches nest; the document is laid
+ *   out once at the end of the outermost batch.
+ */
+void TerminalWindow::beginEdit()
+{
+    if (editDepth++ == 0) {
+        editCursor = QTextCursor(document());
+        editCursor.beginEditBlock();
+    }
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::endEdit
+ *   Ends a batch of changes of the document.
+ */
+void TerminalWindow::endEdit()
+{
+    if (editDepth > 0 && --editDepth == 0) {
+        editCursor.endEditBlock();
+    }
+
+    return;
+}
+
+/**
+ * @brief TerminalWindow::scrollToEnd
+ *   Moves the vertical scrollbar to the end of the document after the current turn of
+ *   the event loop, so the changes of the turn are laid out before and scrolled once.
+ */
+void TerminalWindow::scrollToEnd()
+{
+    if (!scrollTimer->isActive()) scrollTimer->start();
+
+    return;
+}
 
-    // determine the vertical scrollbar of the QTextEdit element
+/**
+ * @brief TerminalWindow::scrollToEndNow
+ *   Moves the vertical scrollbar to the end of the document.
+ */
+void TerminalWindow::scrollToEndNow()
+{
+    // determine the vertical scrollbar of the QPlainTextEdit element
     QScrollBar *vsb = this->verticalScrollBar();
 
     // get the maximum position of the slider and then setup slider's position to the maximum
@@ -484,3 +3317,66 @@ void TerminalWindow::commandFinished(int exitCode, QProcess::ExitStatus exitStat
 
     return;
 }
+
+/**
+ * @brief TerminalWindow::commandFinished
+ *   Is called when the process is finished. Then the process is in the not running state.
+ * @param exitCode
+ * @param exitStatus
+ */
+void TerminalWindow::commandFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+  #ifdef DEBUG
+    cout << "Command executing finished.\n";
+    cout.flush();
+  #endif
+
+    Job *job = findJob(sender());
+
+    if (job == nullptr) return;
+
+    procsFinished++;
+    job->procsFinished++;
+
+    // Process of the pipeline finished, which isn't the last process?
+    if (sender() != job->process) {
+        readJobOutput(job,(QProcess *)sender(),QProcess::StandardError);
+        return;
+    }
+
+    // read the output remaining in the process
+    readJobOutput(job,job->process,QProcess::StandardOutput);
+    readJobOutput(job,job->process,QProcess::StandardError);
+
+    job->finished   = true;
+    job->exitCode   = exitCode;
+    job->exitStatus = exitStatus;
+
+    binarySummary(job);
+
+    cacheJob(job);
+
+    QString usage = profileJob(job);
+
+    // Background job finished? => display the state of the job
+    if (job->background) {
+        if (!job->output.isEmpty() && !job->output.endsWith('\n')) job->output+= '\n';
+        if (exitStatus == QProcess::NormalExit) {
+            job->output+= ANSIRESET "["+QString::number(job->id)+"] "+tr("Done")+" ("+QString::number(exitCode)+")  "+job->cmdLine;
+        } else {
+            job->output+= ANSIRESET "["+QString::number(job->id)+"] "+tr("Terminated")+"  "+job->cmdLine;
+        }
+        if (dspProfile) job->output+= "  ["+usage+"]";
+        job->output+= '\n';
+    } else if (dspProfile) {
+        if (!job->output.isEmpty() && !job->output.endsWith('\n')) job->output+= '\n';
+        job->output+= ANSIRESET "["+usage+"]\n";
+    }
+
+    // the prompt is displayed after the last output of the foreground job
+    if (!flushTimer->isActive()) {
+        flushTimer->start();
+    }
+
+    return;
+}
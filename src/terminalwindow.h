@@ -21,47 +21,296 @@
 #include <iostream>
 #include <QByteArray>
 #include <QChar>
+#include <QColor>
 #include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
 #include <QFont>
+#include <QFontMetrics>
 #include <QKeyEvent>
+#include <QList>
+#include <QMimeData>
+#include <QPlainTextEdit>
 #include <QProcess>
+#include <QRegularExpression>
+#include <QRect>
+#include <QResizeEvent>
 #include <QScrollBar>
 #include <QString>
-#include <QTextCodec>
+#include <QTextBlock>
 #include <QTextCursor>
+#include <QTextDocument>
+#include <QTime>
+#include <QTemporaryFile>
 #include <QTextEdit>
+#include <QTimer>
 #include "main.h"
+#include "ansiparser.h"
+#include "cmdhistory.h"
+#include "cmdprofile.h"
+#include "findbar.h"
+#include "limitedprocess.h"
+#include "linediff.h"
+#include "outputdecoder.h"
+#include "pathindex.h"
+#include "resultcache.h"
+#include "ptyprocess.h"
+#include "scrollbackindex.h"
+#include "sessionlog.h"
+#include "shellsession.h"
 
-class TerminalWindow : public QTextEdit
+#ifdef Q_OS_UNIX
+    #include <signal.h>
+    #include <sys/resource.h>
+#endif
+
+class TerminalWindow : public QPlainTextEdit
 {
     Q_OBJECT
 
+    #define FLUSHINTERVAL  16       // interval in ms for inserting the process output into the document
+    #define FLUSHMAXCHARS  1048576  // maximum number of characters inserted per interval
+    #define COMPLETIONTIME 8        // maximum time in ms for reading a directory for the completion
+    #define COMPLETIONLIST 100      // maximum number of completions displayed
+    #define SAMPLEINTERVAL 50       // interval in ms for sampling the memory usage of the running jobs
+    #define ANSIRESET      "\x1b[0m"  // resets the rendition before the messages of the terminal window
+    #define COUNTDELAY     150      // delay in ms for counting the hits of the search after the last change
+    #define CACHEMAXENTRY  1048576  // maximum number of characters of a cached output
+    #define WATCHINTERVAL  2000     // default interval in ms between the runs of a watched command
+    #define BINARYSAMPLE   4096     // bytes at the start of the output checked for binary data
+    #define BINARYMINIMUM  256      // minimum number of bytes checked before the output is regarded as binary
+    #define BINARYCONTROLS 2        // percentage of control characters indicating binary data
+    #define BINARYINVALID  10       // percentage of invalid UTF-8 bytes indicating binary data
+    #define BINARYPREVIEW  256      // bytes of binary output displayed as hex dump
+    #define STDINCHUNK     65536    // maximum number of input bytes queued in a process
+    #define PASTEECHO      4096     // maximum number of pasted characters displayed as input
+
     int cmdLineStart;
     int cmdLineEnd;
 
-    QProcess *process;
     QDir     *workDir;
     QString   homeDir;
     QChar     wrkDrive;
     QString  *cmdEntered;
+    QList<bool> cmdOperators;  // true = the part of the command line is an unquoted operator
 
     QTextCursor currCursor;
 
+    QTextCharFormat plainFormat;  // format of the prompt and of output without rendition
+
+    // structure of a job = a command executed as process
+    struct Job {
+        int       id;
+        QString   cmdLine;
+        QProcess *process = nullptr; // last process of the pipeline; its output is displayed
+        QList<QProcess *> stages;    // processes of the pipeline
+        ShellSession *session = nullptr;  // persistent shell executing the job instead of the processes
+        PtyProcess   *pty = nullptr;      // pseudo terminal executing the job instead of the processes
+        bool      ptyReturn = false; // the last output of the pseudo terminal ended with \r; may be followed by \n
+        OutputDecoder *decoders[2] = { nullptr, nullptr };  // decoders for the standard output and the standard error channel
+        AnsiParser *ansi = nullptr;       // converts the escape sequences of the output to formats
+        QString   output;            // output not yet inserted into the document
+        bool      background;
+        bool      lineStart = true;  // the next output of a background job starts a new line
+        bool      finished = false;
+        bool      timedOut = false;  // the job was killed after its wall clock time
+        QString   cacheKey;          // key of the output in the result cache; empty = not cached
+        QString   capture;           // output of the job stored in the result cache
+        qint64    sampled = 0;       // bytes of the standard output checked for binary data
+        qsizetype sampleControls = 0;  // control characters in the checked bytes
+        qsizetype sampleInvalid  = 0;  // invalid UTF-8 bytes in the checked bytes
+        QByteArray head;             // checked bytes; written to the spool file if the output is binary
+        bool      binary = false;    // binary output detected => the output is written to the spool file only
+        qint64    binaryBytes = 0;   // bytes of the binary output
+        QTemporaryFile *spool = nullptr;  // binary output of the job
+        QProcess *stdinProcess = nullptr; // process reading the input entered in the terminal; nullptr = no input
+        QByteArray input;            // input not yet written to the process
+        qsizetype inputPos = 0;      // bytes of input already written
+        bool      inputEof = false;  // Ctrl-D pressed => the standard input is closed after the input is written
+        int       exitCode = 0;
+        QProcess::ExitStatus exitStatus = QProcess::NormalExit;
+        QString   entered;                // line entered for the job; key of the profile
+        QElapsedTimer wallTimer;          // wall-clock time since the start of the job
+        int       procsFinished = 0;      // finished processes of the pipeline
+        int       procsFinishedStart = 0; // finished processes of all jobs at the start of the job
+        long      peakRss = 0;            // maximum resident set size in kB
+      #ifdef Q_OS_UNIX
+        struct rusage usageStart;         // resource usage of the terminated child processes at the start of the job
+      #endif
+    };
+
+    // structure of a command of a pipeline with its redirections
+    struct Stage {
+        QStringList args;           // command and arguments of the process
+        QString inFile;             // < file; first command only
+        QString outFile;            // > file or >> file; last command only
+        QString errFile;            // 2> file or 2>> file
+        bool    outAppend = false;
+        bool    errAppend = false;
+        bool    errToOut  = false;  // 2>&1
+    };
+
+    // structure of a command line with pipes and redirections
+    struct Pipeline {
+        QList<Stage> stages;        // commands in the order of the pipeline
+    };
+
+    QList<Job *> jobs;             // running jobs and finished jobs with output not yet inserted
+    Job *fgJob = nullptr;          // job running in the foreground; nullptr = prompt displayed
+
+    OutputDecoder::Encoding encoding;  // encoding of the process output
+
+    QTimer *flushTimer;
+    QTimer *sampleTimer;
+
+    CmdProfile *profile = nullptr;  // durations of the executed commands
+    bool     dspProfile = true;     // display the resource usage after a command
+    int      procsFinished = 0;     // finished processes of all jobs
+    QString  lineEntered;           // line entered before the tilde is replaced
+
+    int scrollbackLines = 0;  // maximum number of lines in the document; 0 = unlimited
+    int scrollbackChars = 0;  // maximum number of characters in the document; 0 = unlimited
+
+    PathIndex    *pathIndex;        // executables of PATH for the completion of commands
+    ShellSession *shell = nullptr;  // persistent shell; nullptr = every command is started as process
+    bool          usePty = false;   // foreground commands are executed in a pseudo terminal
+
+    CmdHistory *history = nullptr;  // history of the entered commands
+    int      histPos = -1;          // number of the command displayed with Up/Down; -1 = entered line displayed
+    QString  histPrefix;            // line entered before the first Up; only commands starting with it are displayed
+    bool     searchMode = false;    // incremental reverse search started with Ctrl-R
+    int      searchPos  = -1;       // number of the command found by the reverse search; -1 = none
+    QString  searchText;            // text searched for
+    QString  searchLine;            // line entered before the reverse search
+
+    ScrollbackIndex *scrollIndex;   // lines of the document for the search in the scrollback
+    int      indexedBlocks = 0;     // blocks of the document copied to the index
+    FindBar *findBar;               // input of the search in the scrollback; opened with Ctrl-F
+    QString  findText;              // text searched in the scrollback
+    int      findBlock  = -1;       // block of the current hit; -1 = none
+    int      findColumn = -1;       // position of the current hit in its block
+    QTimer  *countTimer;            // counts the hits after the input paused
+
+    SessionLog *sessionLog = nullptr;  // log of the commands and their output; nullptr = no log
+
+    LimitedProcess::Limits limits;       // limits of the processes of the external commands
+    LimitedProcess::Limits entryLimits;  // limits of the command selected in the library
+    QString  entryCommand;               // command selected in the library; empty = none
+    int      entryCacheTtl = 0;          // time to live of the cached output of the selected command; 0 = not cached
+
+    ResultCache *cache = nullptr;        // outputs of the cacheable commands
+    bool     refreshCache = false;       // the command was entered with Shift+Return => the cached output isn't used
+
+    bool     watching = false;           // a command is executed repeatedly by watch
+    QString  watchCommand;
+    int      watchInterval = WATCHINTERVAL;
+    int      watchRuns = 0;
+    QTimer  *watchTimer;
+    LimitedProcess *watchProcess = nullptr;  // run of the watched command; nullptr = waiting for the next run
+    QTextCursor watchHeader;             // start of the header line above the output
+    QStringList watchLines;              // lines of the output of the last run
+    QList<bool> watchMarked;             // lines highlighted as changed
+
+    QTemporaryFile *lastSpool = nullptr;  // binary output of the last job; written to a file by save
+
+    int      editDepth = 0;          // nesting depth of the batches of document changes
+    QTextCursor editCursor;          // cursor of the edit block of the outermost batch
+    QTimer  *scrollTimer;            // scrolls to the end once per turn of the event loop
+
+    void beginEdit();
+    void endEdit();
+    void scrollToEnd();
+    void trimScrollback(QTextCursor &cursor);
+
+    QString getCommandLine();
+    void setCommandLine(const QString &line);
+    void historyUp();
+    void historyDown();
+    bool searchKeyPressed(QKeyEvent *event);
+    void searchHistory(int start);
+    void endSearch(bool accept);
+    void completeLine();
+    QStringList completePath(const QString &word);
+    void displayCompletions(const QStringList &matches);
+    void syncIndex();
+    int  findBlockWith(int start, bool backward);
+    void findHit(bool backward);
+    void placeFindBar();
+
     void keyPressEvent(QKeyEvent *event);
+    void resizeEvent(QResizeEvent *event) override;
+    void insertFromMimeData(const QMimeData *source) override;
 
     QStringList *getCommandParts(QString *cmd);
 
+    bool parsePipeline(QStringList *cmdParts, Pipeline &pipeline);
+    const LimitedProcess::Limits &jobLimits(Job *job);
+    void deleteJob(Job *job);
+    Job *findJob(QObject *process);
+    void readJobOutput(Job *job, QProcess *process, int channel);
+    Job *findJob(QStringList *cmdParts);
+    void interruptJob(Job *job);
+    void jobError(Job *job, QObject *process, QProcess::ProcessError error);
+    void captureOutput(Job *job, const QString &text);
+    bool binaryOutput(Job *job, const QByteArray &data);
+    void binarySummary(Job *job);
+    void sendInput(Job *job, const QString &text);
+    void writeInput(Job *job);
+    void cacheJob(Job *job);
+    void replayCached(const QString &output, int exitCode, qint64 age);
+    void startWatch(const QString &command, int interval);
+    void applyWatchOutput(const QStringList &lines, const QString &status);
+    void stopWatch();
+    void insertJobOutput(QTextCursor &cursor, Job *job, int size, bool beforePrompt);
+    void insertTerminalText(QTextCursor &cursor, const QString &text, const QTextCharFormat &format);
+    QString profileJob(Job *job);
+    void executeShell(const QString &line);
+    void executePty(const QString &line);
+    void forwardKey(QKeyEvent *event);
+    void terminalSize(int &cols, int &rows);
+    int  nextJobId();
+
   private slots:
     void commandExternal(QStringList *cmdParts);
     void commandStarted();
     void commandError(QProcess::ProcessError error);
+    void commandTimedOut();
     void commandReadyRead(int channel);
+    void inputWritten(qint64 bytes);
     void commandFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void flushOutput();
+    void scrollToEndNow();
+    void sampleJobs();
+    void shellOutput(QString text);
+    void shellDone(int exitCode, QString pwd);
+    void ptyOutput(QByteArray data);
+    void ptyFinished(int exitCode, bool crashed);
+    void findChanged(QString text);
+    void findNext();
+    void findPrevious();
+    void findClosed();
+    void countHits();
+    void highlightHits();
+    void runWatch();
+    void watchFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void watchError(QProcess::ProcessError error);
 
   public:
-    enum BuiltInCmds { CD, CLEAR, EXIT, NONE };
+    enum BuiltInCmds { CD, CLEAR, EXIT, JOBS, FG, KILL, WATCH, SAVE, NONE };
 
     explicit TerminalWindow(QWidget *parent = nullptr);
+    ~TerminalWindow();
+
+    void setScrollback(int lines, int chars);
+    void setHistory(CmdHistory *hist);
+    void setProfile(CmdProfile *prof, bool display);
+    void setBackend(const QString &backend);
+    void setSessionLog(const QString &fn, int maxMB, int segments);
+    void setLimits(const LimitedProcess::Limits &lim);
+    QString workingDirectory() { return workDir->absolutePath(); }
+    void setEntry(const QString &cmd, const LimitedProcess::Limits &lim, int cacheTtl);
+    void setCache(ResultCache *resCache);
 
   public slots:
     void commandInternal(TerminalWindow::BuiltInCmds cmd, QStringList *cmdParts);
@@ -71,6 +320,7 @@ class TerminalWindow : public QTextEdit
     void commandInt_signal(TerminalWindow::BuiltInCmds,QStringList *);
     void commandExt_signal(QStringList *);
     void commandEntered_signal(QString *);
+    void commandProfiled_signal();
 };
 
 #endif // TERMINALWINDOW_H
@@ -0,0 +1,94 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include "trigramindex.h"
+
+const vector<int> TrigramIndex::noTexts;
+
+/**
+ * @brief TrigramIndex::TrigramIndex
+ *   Constructor of the class TrigramIndex.
+ */
+TrigramIndex::TrigramIndex()
+{
+    return;
+}
+
+/**
+ * @brief TrigramIndex::key
+ * @param text
+ * @param pos
+ * @return key of the three bytes at the position
+ */
+uint32_t TrigramIndex::key(const string &text, size_t pos)
+{
+    return ((uint32_t)(unsigned char)text[pos] << 16) |
+           ((uint32_t)(unsigned char)text[pos+1] << 8) |
+            (uint32_t)(unsigned char)text[pos+2];
+}
+
+/**
+ * @brief TrigramIndex::add
+ *   Adds the trigrams of a text to the index. The texts are added in ascending order,
+ *   so the lists of the index remain sorted.
+ * @param num   number of the text
+ * @param text
+ */
+void TrigramIndex::add(int num, const string &text)
+{
+    for (size_t pos = 0; pos+2 < text.size(); pos++) {
+        vector<int> &postings = trigrams[key(text,pos)];
+        // the same trigram occurs more than once in the text?
+        if (postings.empty() || postings.back() != num) {
+            postings.push_back(num);
+        }
+    }
+
+    return;
+}
+
+/**
+ * @brief TrigramIndex::clear
+ */
+void TrigramIndex::clear()
+{
+    trigrams.clear();
+
+    return;
+}
+
+/**
+ * @brief TrigramIndex::lookup
+ *   Determines the trigram of the text contained in the fewest texts. Only these texts
+ *   may contain the text; the owner compares them.
+ * @param text  at least TRIGRAMLENGTH characters
+ * @return ascending numbers of the texts containing the rarest trigram; empty if a
+ *         trigram of the text isn't contained in any text
+ */
+const vector<int> &TrigramIndex::lookup(const string &text) const
+{
+    const vector<int> *rarest = &noTexts;
+
+    for (size_t pos = 0; pos+2 < text.size(); pos++) {
+        unordered_map<uint32_t,vector<int>>::const_iterator iter = trigrams.find(key(text,pos));
+        // Trigram not contained in any text? => no text contains the text
+        if (iter == trigrams.end()) return noTexts;
+        if (rarest == &noTexts || iter->second.size() < rarest->size()) rarest = &iter->second;
+    }
+
+    return *rarest;
+}
@@ -0,0 +1,52 @@
+/*****************************************************************************
+    Copyright (C) 2024 Rainer Otto <ro2611@m-it-rheinruhr.de>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#ifndef TRIGRAMINDEX_H
+#define TRIGRAMINDEX_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief TrigramIndex
+ *   Index of numbered texts by their trigrams. For every trigram the index holds the
+ *   ascending numbers of the texts containing it, so the search for a substring only
+ *   compares the texts containing the rarest trigram of the substring. The owner keeps
+ *   the texts and compares them; substrings shorter than a trigram can't be looked up.
+ */
+class TrigramIndex
+{
+    #define TRIGRAMLENGTH 3  // minimum length of a substring looked up in the index
+
+    unordered_map<uint32_t,vector<int>> trigrams;  // trigram -> ascending numbers of the texts containing it
+
+    static const vector<int> noTexts;  // result of a lookup if a trigram isn't contained in any text
+
+    static uint32_t key(const string &text, size_t pos);
+
+  public:
+    TrigramIndex();
+    void add(int num, const string &text);  // adds a text; the numbers must be added in ascending order
+    void clear();
+    const vector<int> &lookup(const string &text) const;  // numbers of the texts possibly containing the text
+};
+
+#endif // TRIGRAMINDEX_H